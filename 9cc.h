@@ -2,15 +2,39 @@
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 typedef struct Type Type;
 typedef struct Member Member;
 
+//
+// arena.c
+//
+
+typedef struct ArenaBlock ArenaBlock;
+typedef struct {
+  ArenaBlock *blocks;
+  char *ptr;
+  char *end;
+} Arena;
+
+void *arena_alloc(Arena *arena, size_t size);
+void arena_release(Arena *arena);
+
 //
 // tokenize.c
 //
@@ -24,18 +48,28 @@ typedef enum {
   TK_EOF,
 } TokenKind;
 
+// Tokens are stored contiguously in the order they appear, so the
+// token following `tok` is simply `tok + 1`. The last one is TK_EOF.
 typedef struct Token Token;
 struct Token {
-  TokenKind kind;
-  Token *next;
-  int val;
   char *str;
+  union {
+    int val;        // TK_NUM
+    char *contents; // TK_STR
+    char *name;     // TK_IDENT, interned
+  };
   int len;
-
-  char *contents;
-  char cont_len;
+  int cont_len;
+  TokenKind kind;
 };
 
+// Intern table entry
+typedef struct {
+  char *str;
+  int len;
+  uint32_t hash;
+} InternEntry;
+
 void error(char *fmt, ...);
 void error_at(char *loc, char *fmt, ...);
 void error_tok(Token *tok, char *fmt, ...);
@@ -46,11 +80,20 @@ void expect(char *s);
 int expect_number();
 char *expect_ident(void);
 bool at_eof();
+bool is_alnum(char c);
+char *intern(char *s, int len);
 Token *tokenize();
 
-extern char *filename;
-extern char *user_input;
-Token *token;
+//
+// scan.c
+//
+
+extern char *(*skip_space)(char *p);
+extern char *(*skip_ident)(char *p);
+extern char *(*skip_digits)(char *p);
+extern char *(*find_line_end)(char *p);
+extern char *(*find_comment_end)(char *p);
+void scan_init(void);
 
 //
 // parse.c
@@ -65,6 +108,8 @@ struct Var {
 
   // Local variable
   int offset;
+  bool addr_taken; // by unary &
+  int reg;         // virtual register that holds it, if any
 
   // Global variable
   char *contents;
@@ -77,6 +122,23 @@ struct VarList {
   Var *var;
 };
 
+// A scoped symbol table mapping interned names to their innermost
+// visible binding. See parse.c.
+typedef struct {
+  char *name;
+  void *val;
+} ScopeEntry;
+
+typedef struct {
+  ScopeEntry *map;
+  int cap;
+  int used;
+
+  ScopeEntry *undo;
+  int undo_len;
+  int undo_cap;
+} ScopeMap;
+
 typedef enum {
   ND_ADD,       // +
   ND_PTR_ADD,
@@ -108,53 +170,66 @@ typedef enum {
   ND_NULL,      // null
 } NodeKind;
 
-// AST node type
+// AST node type. Every node starts with the same header, followed by
+// the fields its kind uses. Only those fields are allocated, so a node
+// must never be read through fields of another kind.
 typedef struct Node Node;
 struct Node {
-  NodeKind kind;
   Node *next;
   Type *ty;
   Token *tok;
-  Node *lhs;
-  Node *rhs;
+  NodeKind kind;
+  bool visited; // add_type() is done with this node
 
-  // "if"/"while"/"for" statement
-  Node *cond;
-  Node *then;
-  Node *els;
-  Node *init;
-  Node *inc;
+  union {
+    // Operators, "return" and expression statement
+    struct {
+      Node *lhs;
+      union {
+        Node *rhs;
+        Member *member; // Struct member access
+      };
+    };
 
-  // Block / statement expression
-  Node *body;
+    // "if"/"while"/"for" statement
+    struct {
+      Node *cond;
+      Node *then;
+      Node *els;
+      Node *init;
+      Node *inc;
+    };
 
-  // Struct member access
-  Member *member;
+    // Block / statement expression
+    Node *body;
 
-  // Function call
-  char *funcname;
-  Node *args;
+    // Function call
+    struct {
+      char *funcname;
+      Node *args;
+    };
 
-  Var *var;
-  int val;
+    Var *var;
+    int val;
+  };
 };
 
 typedef struct Function Function;
 struct Function {
-  Function *next;
   char *name;
   VarList *params;
   Node *node;
   VarList *locals;
-  int stack_size;
+
+  // Nodes and local variables, released once the function is emitted.
+  Arena arena;
 };
 
-typedef struct {
-  VarList *globals;
-  Function *fns;
-} Program;
+Function *next_function(void);
 
-Program *program(void);
+// Arguments are only passed in registers, so a function takes at most
+// this many.
+#define MAX_ARGS 6
 
 //
 // type.c
@@ -193,8 +268,378 @@ Type *pointer_to(Type *base);
 Type *array_of(Type *base, int size);
 void add_type(Node *node);
 
+//
+// fold.c
+//
+
+void fold_function(Function *fn);
+
 //
 // codegen.c
 //
 
-void codegen(Program *prog);
+typedef struct CodegenPool CodegenPool;
+
+// x86-64 general-purpose registers, numbered as in the encoding
+typedef enum {
+  RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+  R8, R9, R10, R11, R12, R13, R14, R15,
+} Reg;
+
+typedef enum {
+  OPD_NONE,
+  OPD_REG,   // register
+  OPD_IMM,   // immediate
+  OPD_MEM,   // memory at [reg+val]
+  OPD_SYM,   // address of the symbol `sym`
+  OPD_LABEL, // local label number val
+} OperandKind;
+
+typedef struct {
+  OperandKind kind;
+  int size; // width of a register or memory operand, 1 or 8
+  Reg reg;
+  int val;
+  char *sym;
+} Operand;
+
+typedef enum {
+  I_LABEL, // defines label a
+  I_PUSH,
+  I_POP,
+  I_MOV,
+  I_MOVSX,
+  I_MOVZX,
+  I_LEA,
+  I_ADD,
+  I_SUB,
+  I_IMUL,
+  I_AND,
+  I_CMP,
+  I_CQO,
+  I_IDIV,
+  I_SETE,
+  I_SETNE,
+  I_SETL,
+  I_SETLE,
+  I_SETG,
+  I_SETGE,
+  I_JMP,
+  I_JE,
+  I_JNE,
+  I_JL,
+  I_JLE,
+  I_JG,
+  I_JGE,
+  I_CALL,
+  I_RET,
+} InsKind;
+
+// x86-64 instruction, in Intel operand order
+typedef struct {
+  InsKind kind;
+  Operand a;
+  Operand b;
+} Ins;
+
+typedef struct {
+  Ins *data;
+  int len;
+  int cap;
+} InsList;
+
+// Growable byte buffer
+typedef struct {
+  char *data;
+  size_t len;
+  size_t cap;
+} CodeBuf;
+
+// Relocation of the 4-byte field at `offset` in the text, of ELF type
+// `type` (R_X86_64_*), against the symbol `sym` plus `addend`.
+typedef struct {
+  int offset;
+  int type;
+  char *sym;
+  int addend;
+} Reloc;
+
+// Function defined in the text
+typedef struct {
+  char *name;
+  int offset;
+  int size;
+} FuncSym;
+
+// Output of code generation: assembly text, or machine code with its
+// relocations and function symbols.
+typedef struct {
+  CodeBuf text;
+
+  Reloc *relocs;
+  int relocs_len;
+  int relocs_cap;
+
+  FuncSym *funcs;
+  int funcs_len;
+  int funcs_cap;
+} Object;
+
+typedef enum {
+  FMT_ASM, // assembly
+  FMT_OBJ, // ELF relocatable object
+  FMT_JIT, // machine code loaded to run in this process
+  FMT_IR,  // IR listing
+} OutputFormat;
+
+void buf_append(CodeBuf *buf, void *p, size_t len);
+void codegen_begin(void);
+void codegen_function(Function *fn);
+void codegen_end(VarList *globals);
+void codegen_cancel(void);
+
+//
+// ir.c
+//
+
+typedef enum {
+  IR_IMM,   // d = val
+  IR_MOV,   // d = a
+  IR_SEXT,  // d = the low `size` bytes of a, sign-extended
+  IR_ADD,   // d = a + b
+  IR_SUB,   // d = a - b
+  IR_MUL,   // d = a * b
+  IR_DIV,   // d = a / b
+  IR_EQ,    // d = a == b
+  IR_NE,    // d = a != b
+  IR_LT,    // d = a < b
+  IR_LE,    // d = a <= b
+  IR_LADDR, // d = address of the local at offset val
+  IR_GADDR, // d = address of the global `name`
+  IR_LOAD,  // d = `size` bytes at a
+  IR_STORE, // `size` bytes at a = b
+  IR_PARAM, // d = argument number val
+  IR_CALL,  // d = name(args)
+  IR_JMP,   // goto then
+  IR_BR,    // if a goto then else goto els
+  IR_RET,   // return a, if any
+} IrOp;
+
+typedef struct BasicBlock BasicBlock;
+
+// Three-address instruction. Virtual registers are numbered from 1,
+// and 0 in `d`, `a` or `b` means the operand is unused.
+typedef struct IrIns IrIns;
+struct IrIns {
+  IrIns *next;
+  IrOp op;
+  int d;
+  int a;
+  int b;
+  int val;
+  int size;
+  char *name;
+
+  // IR_CALL
+  int *args;
+  int nargs;
+
+  // IR_JMP, IR_BR
+  BasicBlock *then;
+  BasicBlock *els;
+};
+
+struct BasicBlock {
+  BasicBlock *next; // in layout order
+  int id;
+  IrIns *ins;
+  IrIns *last;
+};
+
+typedef struct {
+  char *name;
+  BasicBlock *blocks; // the first one is the entry
+  int nblocks;
+  int nregs;
+  int nvars; // registers 1 to nvars hold variables, the rest temporaries
+  int stack_size;
+  Arena *arena;
+
+  // Set by alloc_regs(): virtual register v is in spill slot spill[v]
+  // if that is nonzero, and in regs[v] otherwise.
+  Reg *regs;
+  int *spill;
+  int nspills;
+  int used_regs; // bit mask of the Regs allocated
+} IrFunction;
+
+IrFunction *lower_function(Function *fn);
+void dump_ir(IrFunction *fn, CodeBuf *buf);
+
+//
+// regalloc.c
+//
+
+void alloc_regs(IrFunction *fn);
+
+//
+// peephole.c
+//
+
+void peephole(InsList *insns);
+
+//
+// encode.c
+//
+
+// Where code and data go
+typedef enum {
+  SEC_TEXT,
+  SEC_RODATA_STR,
+  SEC_RODATA,
+  SEC_BSS,
+  SEC_UNDEF, // defined elsewhere
+} SectionKind;
+
+// What a name referenced from the text stands for: `val` bytes into
+// `section`. Names are interned or otherwise unique, so a SymMap looks
+// them up by pointer.
+typedef struct {
+  char *name;
+  SectionKind section;
+  int64_t val;
+  int index; // for the user's own numbering
+} SymRef;
+
+typedef struct {
+  SymRef *map;
+  int cap;
+  int used;
+} SymMap;
+
+// Contents of the data sections
+typedef struct {
+  CodeBuf rodata_str;
+  CodeBuf rodata;
+  int bss_size;
+  int bss_align;
+} DataLayout;
+
+void encode_function(char *name, InsList *insns, Object *obj);
+void encode_release(void);
+void merge_object(Object *dst, Object *src);
+void free_object(Object *obj);
+SymRef *sym_get(SymMap *m, char *name);
+SymRef *sym_put(SymMap *m, char *name, SectionKind section, int64_t val);
+void layout_data(VarList *globals, DataLayout *data, SymMap *syms);
+void free_data(DataLayout *data);
+
+//
+// elf.c
+//
+
+void write_elf(Object *obj, VarList *globals);
+
+//
+// jit.c
+//
+
+typedef struct Compiler Compiler;
+
+void jit_load(Object *obj, VarList *globals);
+int jit_run(Compiler *c, int argc, char **argv);
+
+//
+// compile.c
+//
+
+// Receives the generated assembly.
+typedef struct {
+  void (*write)(void *arg, char *buf, size_t len);
+  void *arg;
+} Sink;
+
+// A diagnostic reported during compilation.
+typedef struct Diag Diag;
+struct Diag {
+  Diag *next;
+  char *msg;
+};
+
+// All state of one compilation. A Compiler compiles one translation
+// unit, and separate Compilers may be used concurrently from different
+// threads.
+struct Compiler {
+  char *filename;
+  char *user_input;
+  Sink out;
+
+  // Input read by compile_file(), released with the Compiler
+  char *input_buf;
+  char *input_map;
+  size_t input_map_len;
+
+  // Diagnostics, in the order they were reported
+  Diag *diags;
+
+  // Where error() abandons the compilation
+  jmp_buf *bail;
+
+  // Objects that live as long as the Compiler
+  Arena arena;
+
+  // tokenize.c
+  Token *tokens;
+  int tokens_len;
+  int tokens_cap;
+  Token *token;
+  InternEntry *intern_map;
+  int intern_cap;
+  int intern_used;
+  char *intern_buf;
+  int intern_buf_left;
+
+  // parse.c
+  VarList *locals;
+  VarList *globals;
+  Arena *fn_arena;
+  ScopeMap var_scope;
+  ScopeMap tag_scope;
+  ScopeMap literals; // string literals by interned contents
+  int data_labels;
+
+  // type.c
+  Type **derived_types;
+  int derived_cap;
+  int derived_used;
+
+  // codegen.c
+  int codegen_threads;
+  CodegenPool *codegen_pool;
+  OutputFormat format;
+  bool no_peephole;
+  Object output; // not yet handed to the sink
+
+  // jit.c
+  char *jit_mem;
+  size_t jit_size;
+  void *jit_main;
+};
+
+// The Compiler running on this thread
+extern _Thread_local Compiler *cc;
+
+Compiler *new_compiler(char *filename, Sink out);
+void free_compiler(Compiler *c);
+int compile_input(Compiler *c, char *input);
+int compile_buffer(Compiler *c, char *src, size_t len);
+int compile_file(Compiler *c);
+Sink file_sink(FILE *fp);
+Sink fd_sink(int fd);
+
+//
+// server.c
+//
+
+int serve(char *path);
+int client(char *sock_path, char *path, char *out_path);
@@ -0,0 +1,55 @@
+#include "9cc.h"
+
+// A region allocator. Memory is handed out by bumping a pointer through
+// large zeroed blocks and is only ever released all at once, which is
+// how front-end objects are used: they are created while parsing and
+// all die together once their function, or the whole program, has been
+// emitted.
+
+// Block sizes start small, since most functions need little memory,
+// and double with each new block of the same arena up to a limit.
+#define ARENA_MIN_BLOCK (4 * 1024)
+#define ARENA_MAX_BLOCK (1024 * 1024)
+
+struct ArenaBlock {
+  ArenaBlock *next;
+  max_align_t data[];
+};
+
+// Returns `size` bytes of zeroed memory from `arena`.
+void *arena_alloc(Arena *arena, size_t size) {
+  size = align_to(size, _Alignof(max_align_t));
+
+  if (arena->end - arena->ptr < size) {
+    size_t cap = ARENA_MIN_BLOCK;
+    if (arena->blocks)
+      cap = 2 * (arena->end - (char *)arena->blocks->data);
+    if (cap > ARENA_MAX_BLOCK)
+      cap = ARENA_MAX_BLOCK;
+    if (cap < size)
+      cap = size;
+
+    ArenaBlock *blk = calloc(1, sizeof(ArenaBlock) + cap);
+    if (!blk)
+      error("out of memory");
+    blk->next = arena->blocks;
+    arena->blocks = blk;
+    arena->ptr = (char *)blk->data;
+    arena->end = arena->ptr + cap;
+  }
+
+  void *p = arena->ptr;
+  arena->ptr += size;
+  return p;
+}
+
+// Frees everything allocated from `arena`. The arena can be reused.
+void arena_release(Arena *arena) {
+  ArenaBlock *blk = arena->blocks;
+  while (blk) {
+    ArenaBlock *next = blk->next;
+    free(blk);
+    blk = next;
+  }
+  *arena = (Arena){};
+}
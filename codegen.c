@@ -1,312 +1,843 @@
 #include "9cc.h"
 
-static char *argreg1[] = {"dil", "sil", "dl", "cl", "r8b", "r9b"};
-static char *argreg8[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
-
-static int labelseq = 1;
-static char *funcname;
-
-static void gen(Node *node);
-
-void gen_addr(Node *node) {
-  switch (node->kind) {
-    case ND_VAR: {
-                  Var *var = node->var;
-                  if (var->is_local) {
-                    printf("  lea rax, [rbp-%d]\n", var->offset);
-                    printf("  push rax\n");
-                  } else {
-                    printf("  push offset %s\n", var->name);
-                  }
-                  return;
-                 }
-    case ND_DEREF:
-      gen(node->lhs);
-      return;
-    case ND_MEMBER:
-      gen_addr(node->lhs);
-      printf("  pop rax\n");
-      printf("  add rax, %d\n", node->member->offset);
-      printf("  push rax\n");
-      return;
+// Code generation lowers each function to IR (see ir.c) and selects a
+// list of x86-64 instructions for it, which is then either printed as
+// assembly or encoded into machine code by encode.c.
+
+static Reg argreg[] = {RDI, RSI, RDX, RCX, R8, R9};
+
+// Each function is generated into a buffer of its own, possibly on a
+// worker thread, and the buffers are written out in source order. The
+// state below belongs to the function being generated on this thread.
+static _Thread_local InsList insns;
+static _Thread_local CodeBuf *out;
+static _Thread_local char *funcname;
+
+// Output is handed to the sink in chunks of at least this size.
+#define OUTPUT_CHUNK (256 * 1024)
+
+void buf_append(CodeBuf *buf, void *p, size_t len) {
+  if (buf->cap - buf->len < len) {
+    buf->cap = buf->cap ? buf->cap * 2 : 4096;
+    if (buf->cap < buf->len + len)
+      buf->cap = buf->len + len;
+    buf->data = realloc(buf->data, buf->cap);
   }
+  memcpy(buf->data + buf->len, p, len);
+  buf->len += len;
+}
 
-  error_tok(node->tok, "Not an lvalue");
+static void put_int(CodeBuf *buf, int val) {
+  char tmp[16];
+  char *p = tmp + sizeof(tmp);
+  unsigned u = val < 0 ? -(unsigned)val : val;
+  do {
+    *--p = '0' + u % 10;
+    u /= 10;
+  } while (u);
+  if (val < 0)
+    *--p = '-';
+  buf_append(buf, p, tmp + sizeof(tmp) - p);
 }
 
-static void gen_lvar(Node *node) {
-  if (node->ty->kind == TY_ARRAY)
-    error_tok(node->tok, "Not an lvalue");
-  gen_addr(node);
+// Appends assembly to the current buffer. The format understands only
+// %d and %s, which is all codegen needs, and is much cheaper than
+// printf's.
+static void emit(char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  for (;;) {
+    char *p = strchrnul(fmt, '%');
+    buf_append(out, fmt, p - fmt);
+    if (!*p)
+      break;
+
+    if (p[1] == 'd') {
+      put_int(out, va_arg(ap, int));
+    } else {
+      assert(p[1] == 's');
+      char *s = va_arg(ap, char *);
+      buf_append(out, s, strlen(s));
+    }
+    fmt = p + 2;
+  }
+  va_end(ap);
 }
 
-static void load(Type *ty) {
-  printf("  pop rax\n");
-  if (ty->size == 1)
-    printf("  movsx rax, byte ptr [rax]\n");
-  else
-    printf("  mov rax, [rax]\n");
-  printf("  push rax\n");
+static bool is_machine_code(OutputFormat format) {
+  return format == FMT_OBJ || format == FMT_JIT;
 }
 
-static void store(Type *ty) {
-  printf("  pop rdi\n");
-  printf("  pop rax\n");
+// Hands the pending output to the Compiler's sink.
+static void write_output(void) {
+  CodeBuf *buf = &cc->output.text;
+  if (buf->len)
+    cc->out.write(cc->out.arg, buf->data, buf->len);
+  buf->len = 0;
+}
 
-  if (ty->size == 1)
-    printf("  mov [rax], dil\n");
-  else
-    printf("  mov [rax], rdi\n");
-  printf("  push rdi\n");
+// Adds a function's finished output to the Compiler's and frees it.
+// Small assembly buffers are gathered so that the sink sees few, large
+// writes. Machine code is kept until the object file is written.
+static void flush(Object *obj) {
+  if (is_machine_code(cc->format)) {
+    merge_object(&cc->output, obj);
+  } else if (obj->text.len >= OUTPUT_CHUNK) {
+    write_output();
+    cc->out.write(cc->out.arg, obj->text.data, obj->text.len);
+  } else {
+    buf_append(&cc->output.text, obj->text.data, obj->text.len);
+    if (cc->output.text.len >= OUTPUT_CHUNK)
+      write_output();
+  }
+  free_object(obj);
+}
+
+//
+// Instructions
+//
+
+static Operand reg(Reg r) {
+  return (Operand){OPD_REG, 8, r};
+}
+
+static Operand reg8(Reg r) {
+  return (Operand){OPD_REG, 1, r};
+}
+
+static Operand imm(int val) {
+  return (Operand){OPD_IMM, .val = val};
+}
+
+static Operand mem(Reg base, int disp, int size) {
+  return (Operand){OPD_MEM, size, base, disp};
+}
+
+static Operand sym(char *name) {
+  return (Operand){OPD_SYM, .sym = name};
+}
+
+// Labels are the basic blocks of a function, numbered from 1, and the
+// epilogue.
+#define RETURN_LABEL 0
+
+static Operand label(int id) {
+  return (Operand){OPD_LABEL, .val = id};
+}
+
+static void ins(InsKind kind, Operand a, Operand b) {
+  if (insns.len == insns.cap) {
+    insns.cap = insns.cap ? insns.cap * 2 : 1024;
+    insns.data = realloc(insns.data, sizeof(Ins) * insns.cap);
+  }
+  insns.data[insns.len++] = (Ins){kind, a, b};
+}
+
+static void ins1(InsKind kind, Operand a) {
+  ins(kind, a, (Operand){});
+}
+
+static void ins0(InsKind kind) {
+  ins(kind, (Operand){}, (Operand){});
+}
+
+//
+// Assembly printer
+//
+
+static char *mnemonics[] = {
+  [I_PUSH] = "push", [I_POP] = "pop", [I_MOV] = "mov", [I_MOVSX] = "movsx",
+  [I_MOVZX] = "movzx", [I_LEA] = "lea", [I_ADD] = "add", [I_SUB] = "sub",
+  [I_IMUL] = "imul", [I_AND] = "and", [I_CMP] = "cmp", [I_CQO] = "cqo",
+  [I_IDIV] = "idiv", [I_SETE] = "sete", [I_SETNE] = "setne", [I_SETL] = "setl",
+  [I_SETLE] = "setle", [I_SETG] = "setg", [I_SETGE] = "setge", [I_JMP] = "jmp",
+  [I_JE] = "je", [I_JNE] = "jne", [I_JL] = "jl", [I_JLE] = "jle", [I_JG] = "jg",
+  [I_JGE] = "jge", [I_CALL] = "call", [I_RET] = "ret",
+};
+
+static char *regs64[] = {
+  "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+  "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+};
+
+static char *regs8[] = {
+  "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil",
+  "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
+};
+
+// The printer writes straight into the buffer. Each instruction takes
+// at most this many bytes plus the length of the names in it.
+#define MAX_INS_TEXT 64
+
+static char *print_str(char *p, char *s) {
+  while (*s)
+    *p++ = *s++;
+  return p;
+}
+
+static char *print_int(char *p, int val) {
+  char tmp[16];
+  char *q = tmp + sizeof(tmp);
+  unsigned u = val < 0 ? -(unsigned)val : val;
+  do {
+    *--q = '0' + u % 10;
+    u /= 10;
+  } while (u);
+  if (val < 0)
+    *--q = '-';
+  memcpy(p, q, tmp + sizeof(tmp) - q);
+  return p + (tmp + sizeof(tmp) - q);
+}
+
+static char *print_label(char *p, int id) {
+  if (id == RETURN_LABEL) {
+    p = print_str(p, ".L.return.");
+    return print_str(p, funcname);
+  }
+  p = print_str(p, ".L.");
+  p = print_str(p, funcname);
+  *p++ = '.';
+  return print_int(p, id);
+}
+
+static char *print_operand(char *p, Operand *op, InsKind kind) {
+  switch (op->kind) {
+  case OPD_REG:
+    return print_str(p, op->size == 1 ? regs8[op->reg] : regs64[op->reg]);
+  case OPD_IMM:
+    return print_int(p, op->val);
+  case OPD_MEM:
+    if (op->size == 1)
+      p = print_str(p, "byte ptr ");
+    *p++ = '[';
+    p = print_str(p, regs64[op->reg]);
+    if (op->val > 0)
+      *p++ = '+';
+    if (op->val)
+      p = print_int(p, op->val);
+    *p++ = ']';
+    return p;
+  case OPD_SYM:
+    if (kind != I_CALL)
+      p = print_str(p, "offset ");
+    return print_str(p, op->sym);
+  case OPD_LABEL:
+    return print_label(p, op->val);
+  }
+  return p;
+}
+
+static void print_function(char *name, InsList *list) {
+  emit(".global %s\n", name);
+  emit("%s:\n", name);
+
+  size_t name_len = strlen(name);
+  for (Ins *i = list->data; i < list->data + list->len; i++) {
+    size_t max = MAX_INS_TEXT + name_len;
+    if (i->a.kind == OPD_SYM)
+      max += strlen(i->a.sym);
+    if (i->b.kind == OPD_SYM)
+      max += strlen(i->b.sym);
+    if (out->cap - out->len < max) {
+      out->cap = out->cap * 2 > out->len + max ? out->cap * 2 : out->len + max;
+      out->data = realloc(out->data, out->cap);
+    }
+
+    char *p = out->data + out->len;
+    if (i->kind == I_LABEL) {
+      p = print_label(p, i->a.val);
+      *p++ = ':';
+    } else {
+      *p++ = ' ';
+      *p++ = ' ';
+      p = print_str(p, mnemonics[i->kind]);
+      if (i->a.kind) {
+        *p++ = ' ';
+        p = print_operand(p, &i->a, i->kind);
+      }
+      if (i->b.kind) {
+        *p++ = ',';
+        *p++ = ' ';
+        p = print_operand(p, &i->b, i->kind);
+      }
+    }
+    *p++ = '\n';
+    out->len = p - out->data;
+  }
+}
+
+//
+// Instruction selection
+//
+
+// The function being generated on this thread, with its virtual
+// registers allocated by regalloc.c. Spilled operands are loaded into
+// rax and r11, spilled results are computed in rax, and rdx is left
+// for division.
+static _Thread_local IrFunction *cur_fn;
+static _Thread_local int spill_base;
+
+static Operand spill_slot(int n) {
+  return mem(RBP, -(spill_base + n * 8), 8);
+}
+
+// Where virtual register v lives
+static Operand loc(int v) {
+  if (cur_fn->spill[v])
+    return spill_slot(cur_fn->spill[v]);
+  return reg(cur_fn->regs[v]);
+}
+
+// Returns a register holding v, loading it into `scratch` if spilled.
+static Reg use(int v, Reg scratch) {
+  if (!cur_fn->spill[v])
+    return cur_fn->regs[v];
+  ins(I_MOV, reg(scratch), loc(v));
+  return scratch;
+}
+
+// Returns the register to compute v in. def_done() then stores it if
+// v is spilled.
+static Reg def(int v) {
+  return cur_fn->spill[v] ? RAX : cur_fn->regs[v];
+}
+
+static void def_done(int v, Reg r) {
+  if (cur_fn->spill[v])
+    ins(I_MOV, loc(v), reg(r));
+}
+
+static void mov(Reg dst, Reg src) {
+  if (dst != src)
+    ins(I_MOV, reg(dst), reg(src));
+}
+
+static bool is_callee_saved(Reg r) {
+  return r == RBX || r >= R12;
+}
+
+// Moves src[i] to dst[i] for all i as if all the sources were read
+// before any destination is written. The destinations are distinct,
+// and at most one operand of each move is a spill slot.
+static void parallel_move(Operand *dst, Operand *src, int n) {
+  bool done[MAX_ARGS] = {};
+  for (int i = 0; i < n; i++) {
+    if (dst[i].kind == OPD_MEM) {
+      ins(I_MOV, dst[i], src[i]);
+      done[i] = true;
+    }
+  }
+
+  // Register-to-register moves, in an order that reads each register
+  // before it is overwritten. What is left after that are cycles, which
+  // are broken by saving one register of the cycle in r11.
+  for (;;) {
+    bool progress = false;
+    int pending = -1;
+    for (int i = 0; i < n; i++) {
+      if (done[i] || src[i].kind == OPD_MEM)
+        continue;
+      if (src[i].reg == dst[i].reg) {
+        done[i] = true;
+        continue;
+      }
+
+      bool blocked = false;
+      for (int j = 0; j < n; j++)
+        if (j != i && !done[j] && src[j].kind == OPD_REG && src[j].reg == dst[i].reg)
+          blocked = true;
+      if (blocked) {
+        pending = i;
+        continue;
+      }
+      ins(I_MOV, dst[i], src[i]);
+      done[i] = progress = true;
+    }
+
+    if (pending < 0)
+      break;
+    if (!progress) {
+      Reg r = dst[pending].reg;
+      ins(I_MOV, reg(R11), reg(r));
+      for (int j = 0; j < n; j++)
+        if (!done[j] && src[j].kind == OPD_REG && src[j].reg == r)
+          src[j] = reg(R11);
+    }
+  }
+
+  for (int i = 0; i < n; i++)
+    if (src[i].kind == OPD_MEM)
+      ins(I_MOV, dst[i], src[i]);
+}
+
+// Takes the arguments out of their registers. `i` is the first of the
+// function's IR_PARAMs, which all come first.
+static void select_params(IrIns *i) {
+  Operand dst[MAX_ARGS], src[MAX_ARGS];
+  int n = 0;
+  for (; i && i->op == IR_PARAM; i = i->next) {
+    dst[n] = loc(i->d);
+    src[n++] = reg(argreg[i->val]);
+  }
+  parallel_move(dst, src, n);
 }
 
-static void gen(Node *node) {
-  switch (node->kind) {
-  case ND_NULL:
+static void select_call(IrIns *i) {
+  Operand dst[MAX_ARGS], src[MAX_ARGS];
+  for (int j = 0; j < i->nargs; j++) {
+    dst[j] = reg(argreg[j]);
+    src[j] = loc(i->args[j]);
+  }
+  parallel_move(dst, src, i->nargs);
+
+  // Caller-saved registers hold nothing that is live across the call.
+  ins(I_MOV, reg(RAX), imm(0));
+  ins1(I_CALL, sym(i->name));
+  Reg d = def(i->d);
+  mov(d, RAX);
+  def_done(i->d, d);
+}
+
+static InsKind setcc[] = {
+  [IR_EQ] = I_SETE, [IR_NE] = I_SETNE, [IR_LT] = I_SETL, [IR_LE] = I_SETLE,
+};
+
+static InsKind alu[] = {[IR_ADD] = I_ADD, [IR_SUB] = I_SUB, [IR_MUL] = I_IMUL};
+
+// Generates `i`, which is the last instruction of the function if
+// `last`. `next` is the block that follows in the layout; jumps to it
+// are left out.
+static void select_ins(IrIns *i, BasicBlock *next, bool last) {
+  switch (i->op) {
+  case IR_IMM: {
+    Reg d = def(i->d);
+    ins(I_MOV, reg(d), imm(i->val));
+    def_done(i->d, d);
+    return;
+  }
+  case IR_MOV: {
+    Reg a = use(i->a, RAX);
+    Reg d = def(i->d);
+    mov(d, a);
+    def_done(i->d, d);
+    return;
+  }
+  case IR_SEXT: {
+    Reg a = use(i->a, RAX);
+    Reg d = def(i->d);
+    ins(I_MOVSX, reg(d), reg8(a));
+    def_done(i->d, d);
+    return;
+  }
+  case IR_ADD:
+  case IR_SUB:
+  case IR_MUL: {
+    Reg a = use(i->a, RAX);
+    Reg b = use(i->b, R11);
+    Reg d = def(i->d);
+
+    // The result may have the register of an operand that dies here.
+    if (d == b && d != a) {
+      if (i->op == IR_SUB) {
+        mov(R11, b);
+        b = R11;
+      } else {
+        b = a;
+        a = d;
+      }
+    }
+    mov(d, a);
+    ins(alu[i->op], reg(d), reg(b));
+    def_done(i->d, d);
+    return;
+  }
+  case IR_DIV: {
+    mov(RAX, use(i->a, RAX));
+    Reg b = use(i->b, R11);
+    ins0(I_CQO);
+    ins1(I_IDIV, reg(b));
+    Reg d = def(i->d);
+    mov(d, RAX);
+    def_done(i->d, d);
+    return;
+  }
+  case IR_EQ:
+  case IR_NE:
+  case IR_LT:
+  case IR_LE: {
+    Reg a = use(i->a, RAX);
+    Reg b = use(i->b, R11);
+    Reg d = def(i->d);
+    ins(I_CMP, reg(a), reg(b));
+    ins1(setcc[i->op], reg8(d));
+    ins(I_MOVZX, reg(d), reg8(d));
+    def_done(i->d, d);
+    return;
+  }
+  case IR_LADDR: {
+    Reg d = def(i->d);
+    ins(I_LEA, reg(d), mem(RBP, -i->val, 8));
+    def_done(i->d, d);
+    return;
+  }
+  case IR_GADDR: {
+    Reg d = def(i->d);
+    ins(I_MOV, reg(d), sym(i->name));
+    def_done(i->d, d);
     return;
-  case ND_NUM:
-    printf("  push %d\n", node->val);
+  }
+  case IR_LOAD: {
+    Reg a = use(i->a, RAX);
+    Reg d = def(i->d);
+    if (i->size == 1)
+      ins(I_MOVSX, reg(d), mem(a, 0, 1));
+    else
+      ins(I_MOV, reg(d), mem(a, 0, 8));
+    def_done(i->d, d);
     return;
-  case ND_EXPR_STMT:
-    gen(node->lhs);
-    printf("  add rsp, 8\n");
+  }
+  case IR_STORE: {
+    Reg a = use(i->a, RAX);
+    Reg b = use(i->b, R11);
+    if (i->size == 1)
+      ins(I_MOV, mem(a, 0, 1), reg8(b));
+    else
+      ins(I_MOV, mem(a, 0, 8), reg(b));
     return;
-  case ND_VAR:
-  case ND_MEMBER:
-    gen_addr(node);
-    if (node->ty->kind != TY_ARRAY)
-      load(node->ty);
+  }
+  case IR_PARAM:
+    if (i->val == 0)
+      select_params(i);
     return;
-  case ND_ASSIGN:
-    gen_lvar(node->lhs);
-    gen(node->rhs);
-    store(node->ty);
+  case IR_CALL:
+    select_call(i);
     return;
-  case ND_ADDR:
-    gen_addr(node->lhs);
+  case IR_JMP:
+    if (i->then != next)
+      ins1(I_JMP, label(i->then->id));
     return;
-  case ND_DEREF:
-    gen(node->lhs);
-    if (node->ty->kind != TY_ARRAY)
-      load(node->ty);
+  case IR_BR:
+    ins(I_CMP, reg(use(i->a, RAX)), imm(0));
+    if (i->els == next) {
+      ins1(I_JNE, label(i->then->id));
+      return;
+    }
+    ins1(I_JE, label(i->els->id));
+    if (i->then != next)
+      ins1(I_JMP, label(i->then->id));
     return;
-  case ND_IF: {
-                int seq = labelseq++;
-                if (node->els) {
-                  gen(node->cond);
-                  printf("  pop rax\n");
-                  printf("  cmp rax, 0\n");
-                  printf("  je  .L.else.%d\n", seq);
-                  gen(node->then);
-                  printf("  jmp .L.end.%d\n", seq);
-                  printf(".L.else.%d:\n", seq);
-                  gen(node->els);
-                  printf(".L.end.%d:\n", seq);
-                } else {
-                  gen(node->cond);
-                  printf("  pop rax\n");
-                  printf("  cmp rax, 0\n");
-                  printf("  je  .L.end.%d\n", seq);
-                  gen(node->then);
-                  printf(".L.end.%d:\n", seq);
-                }
-                return;
-              }
-  case ND_WHILE: {
-                   int seq = labelseq++;
-                   printf(".L.begin.%d:\n", seq);
-                   gen(node->cond);
-                   printf("  pop rax\n");
-                   printf("  cmp rax, 0\n");
-                   printf("  je  .L.end.%d\n", seq);
-                   gen(node->then);
-                   printf("  jmp .L.begin.%d\n", seq);
-                   printf(".L.end.%d:\n", seq);
-                   return;
-                 }
-  case ND_FOR: {
-                 int seq = labelseq++;
-                 if (node->init)
-                   gen(node->init);
-                 printf(".L.begin.%d:\n", seq);
-                 if (node->cond) {
-                   gen(node->cond);
-                   printf("  pop rax\n");
-                   printf("  cmp rax, 0\n");
-                   printf("  je  .L.end.%d\n", seq);
-                 }
-                 gen(node->then);
-                 if (node->inc)
-                   gen(node->inc);
-                 printf("  jmp .L.begin.%d\n", seq);
-                 printf(".L.end.%d:\n", seq);
-                 return;
-               }
-  case ND_BLOCK:
-  case ND_STMT_EXPR:
-     for (Node *n = node->body; n; n = n->next)
-       gen(n);
-     return;
-  case ND_FCALL: {
-                   int nargs = 0;
-                   for (Node *arg = node->args; arg; arg = arg->next) {
-                     gen(arg);
-                     nargs++;
-                   }
-
-                   for (int i = nargs - 1; i >= 0; i--)
-                     printf("  pop %s\n", argreg8[i]);
-
-                   int seq = labelseq++;
-                   printf("  mov rax, rsp\n");
-                   printf("  and rax, 15\n");
-                   printf("  jnz .L.call.%d\n", seq);
-                   printf("  mov rax, 0\n");
-                   printf("  call %s\n", node->funcname);
-                   printf("  jmp .L.end.%d\n", seq);
-                   printf(".L.call.%d:\n", seq);
-                   printf("  sub rsp, 8\n");
-                   printf("  mov rax, 0\n");
-                   printf("  call %s\n", node->funcname);
-                   printf("  add rsp, 8\n");
-                   printf(".L.end.%d:\n", seq);
-                   printf("  push rax\n");
-                   return;
-                 }
-  case ND_RETURN:
-    gen(node->lhs);
-    printf("  pop rax\n");
-    printf("  jmp .L.return.%s\n", funcname);
+  case IR_RET:
+    if (i->a)
+      mov(RAX, use(i->a, RAX));
+    if (!last)
+      ins1(I_JMP, label(RETURN_LABEL));
     return;
   }
+}
+
+// Appends the `len` bytes at `s` as the body of a quoted string.
+static void put_escaped(CodeBuf *buf, char *s, int len) {
+  for (int i = 0; i < len; i++) {
+    unsigned char c = s[i];
+    if (c == '"' || c == '\\') {
+      char esc[2] = {'\\', c};
+      buf_append(buf, esc, 2);
+    } else if (isprint(c)) {
+      buf_append(buf, &c, 1);
+    } else {
+      char oct[4] = {'\\', '0' + (c >> 6), '0' + (c >> 3 & 7), '0' + (c & 7)};
+      buf_append(buf, oct, 4);
+    }
+  }
+}
+
+// String literals go to read-only sections. Those without an embedded
+// NUL are put in a mergeable string section, where the linker folds
+// identical strings across object files. Other globals have no
+// initializer and go to .bss, which takes no space in the object file.
+// layout_data() in encode.c follows the same layout for -c and --run.
+static void emit_data(VarList *globals) {
+  emit(".section .rodata.str1.1,\"aMS\",@progbits,1\n");
+  for (VarList *vl = globals; vl; vl = vl->next) {
+    Var *var = vl->var;
+    if (var->contents && !memchr(var->contents, '\0', var->cont_len - 1)) {
+      emit("%s:\n", var->name);
+      emit("  .string \"");
+      put_escaped(out, var->contents, var->cont_len - 1);
+      emit("\"\n");
+    }
+  }
 
-  gen(node->lhs);
-  gen(node->rhs);
-
-  printf("  pop rdi\n");
-  printf("  pop rax\n");
-
-  switch (node->kind) {
-  case ND_ADD:
-    printf("  add rax, rdi\n");
-    break;
-  case ND_PTR_ADD:
-    printf("  imul rdi, %d\n", node->ty->base->size);
-    printf("  add rax, rdi\n");
-    break;
-  case ND_SUB:
-    printf("  sub rax, rdi\n");
-    break;
-  case ND_PTR_SUB:
-    printf("  imul rdi, %d\n", node->ty->base->size);
-    printf("  sub rax, rdi\n");
-    break;
-  case ND_PTR_DIFF:
-    printf("  sub rax, rdi\n");
-    printf("  cqo\n");
-    printf("  mov rdi, %d\n", node->lhs->ty->base->size);
-    printf("  idiv rdi\n");
-    break;
-  case ND_MUL:
-    printf("  imul rax, rdi\n");
-    break;
-  case ND_DIV:
-    printf("  cqo\n");
-    printf("  idiv rdi\n");
-    break;
-  case ND_EQ:
-    printf("  cmp rax, rdi\n");
-    printf("  sete al\n");
-    printf("  movzb rax, al\n");
-    break;
-  case ND_NE:
-    printf("  cmp rax, rdi\n");
-    printf("  setne al\n");
-    printf("  movzb rax, al\n");
-    break;
-  case ND_LT:
-    printf("  cmp rax, rdi\n");
-    printf("  setl al\n");
-    printf("  movzb rax, al\n");
-    break;
-  case ND_LE:
-    printf("  cmp rax, rdi\n");
-    printf("  setle al\n");
-    printf("  movzb rax, al\n");
-    break;
-  case ND_GT:
-    printf("  cmp rax, rdi\n");
-    printf("  setg al\n");
-    printf("  movzb rax, al\n");
-    break;
-  case ND_GE:
-    printf("  cmp rax, rdi\n");
-    printf("  setge al\n");
-    printf("  movzb rax, al\n");
-    break;
-  }
-
-  printf("  push rax\n");
-}
-
-static void emit_data(Program *prog) {
-  printf(".data\n");
-
-  for (VarList *vl = prog->globals; vl; vl = vl->next) {
+  emit(".section .rodata\n");
+  for (VarList *vl = globals; vl; vl = vl->next) {
     Var *var = vl->var;
-    printf("%s:\n", var->name);
+    if (var->contents && memchr(var->contents, '\0', var->cont_len - 1)) {
+      emit("%s:\n", var->name);
+      emit("  .ascii \"");
+      put_escaped(out, var->contents, var->cont_len);
+      emit("\"\n");
+    }
+  }
 
+  emit(".bss\n");
+  for (VarList *vl = globals; vl; vl = vl->next) {
+    Var *var = vl->var;
     if (!var->contents) {
-      printf("  .zero %d\n", var->ty->size);
-      continue;
+      emit("  .align %d\n", var->ty->align);
+      emit("%s:\n", var->name);
+      emit("  .zero %d\n", var->ty->size);
     }
-
-    for (int i = 0; i < var->cont_len; i++)
-      printf("  .byte %d\n", var->contents[i]);
   }
 }
 
-static void load_arg(Var *var, int idx) {
-  int sz = var->ty->size;
-  if (sz == 1) {
-    printf("  mov [rbp-%d], %s\n", var->offset, argreg1[idx]);
+
+// Generates `fn` into `obj` in the given format and releases the
+// function's arena. The instructions go through peephole.c unless
+// `no_peephole`.
+static void gen_function(Function *fn, Object *obj, OutputFormat format, bool no_peephole) {
+  fold_function(fn);
+  IrFunction *ir = lower_function(fn);
+  if (format == FMT_IR) {
+    dump_ir(ir, &obj->text);
+    arena_release(&fn->arena);
+    return;
+  }
+  alloc_regs(ir);
+
+  funcname = fn->name;
+  insns.len = 0;
+  cur_fn = ir;
+
+  // Below the locals are the spill slots, and below those the
+  // callee-saved registers that the function uses.
+  spill_base = ir->stack_size;
+  int offset = spill_base + ir->nspills * 8;
+  int saved[R15 + 1];
+  for (Reg r = RAX; r <= R15; r++)
+    if (ir->used_regs >> r & 1 && is_callee_saved(r))
+      saved[r] = offset += 8;
+
+  // Prologue
+  ins1(I_PUSH, reg(RBP));
+  ins(I_MOV, reg(RBP), reg(RSP));
+  if (offset)
+    ins(I_SUB, reg(RSP), imm(align_to(offset, 16)));
+  for (Reg r = RAX; r <= R15; r++)
+    if (ir->used_regs >> r & 1 && is_callee_saved(r))
+      ins(I_MOV, mem(RBP, -saved[r], 8), reg(r));
+
+  for (BasicBlock *bb = ir->blocks; bb; bb = bb->next) {
+    ins1(I_LABEL, label(bb->id));
+    for (IrIns *i = bb->ins; i; i = i->next)
+      select_ins(i, bb->next, !bb->next && !i->next);
+  }
+
+  // Epilogue
+  ins1(I_LABEL, label(RETURN_LABEL));
+  for (Reg r = RAX; r <= R15; r++)
+    if (ir->used_regs >> r & 1 && is_callee_saved(r))
+      ins(I_MOV, reg(r), mem(RBP, -saved[r], 8));
+  ins(I_MOV, reg(RSP), reg(RBP));
+  ins1(I_POP, reg(RBP));
+  ins0(I_RET);
+
+  arena_release(&fn->arena);
+
+  if (!no_peephole)
+    peephole(&insns);
+
+  if (is_machine_code(format)) {
+    encode_function(fn->name, &insns, obj);
   } else {
-    assert(sz == 8);
-    printf("  mov [rbp-%d], %s\n", var->offset, argreg8[idx]);
+    out = &obj->text;
+    print_function(fn->name, &insns);
   }
 }
 
-static void emit_text(Program *prog) {
-  printf(".text\n");
-  for (Function *fn = prog->fns; fn; fn = fn->next) {
-    printf(".global %s\n", fn->name);
-    printf("%s:\n", fn->name);
-    funcname = fn->name;
+// Frees the buffers that the calling thread reuses from one function to
+// the next. Threads call this once they are done generating code, as
+// compile and worker threads come and go.
+static void release_buffers(void) {
+  free(insns.data);
+  insns = (InsList){};
+  encode_release();
+}
 
-    // Prologue
-    printf("  push rbp\n");
-    printf("  mov rbp, rsp\n");
-    printf("  sub rsp, %d\n", fn->stack_size);
+// Functions are generated in a pipeline with the parser: with more than
+// one codegen thread, a pool of threads generates functions
+// while later ones are still being parsed. The pool keeps a window of
+// functions in a ring of `cap` slots. Functions [flushed, next) are
+// being generated and [next, len) are waiting for a thread; done[] is
+// set for a slot once its buffer is complete. Only the compiling thread
+// queues and writes out functions, always in source order.
+struct CodegenPool {
+  pthread_t *threads;
+  int nthreads;
 
-    // Push arguments to the stack
-    int i = 0;
-    for (VarList *vl = fn->params; vl; vl = vl->next) {
-      load_arg(vl->var, i++);
-    }
+  Function **fns;
+  Object *outs;
+  bool *done;
+  int cap;
+
+  int len;
+  int next;
+  int flushed;
+  bool closing;
+  OutputFormat format;
+  bool no_peephole;
 
-    for (Node *node = fn->node; node; node = node->next)
-      gen(node);
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+};
 
-    // Epilogue
-    printf(".L.return.%s:\n", funcname);
-    printf("  mov rsp, rbp\n");
-    printf("  pop rbp\n");
-    printf("  ret\n");
+static void *codegen_worker(void *arg) {
+  CodegenPool *pool = arg;
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->next == pool->len && !pool->closing)
+      pthread_cond_wait(&pool->cond, &pool->lock);
+    if (pool->next == pool->len)
+      break;
+
+    int slot = pool->next++ % pool->cap;
+    pthread_mutex_unlock(&pool->lock);
+    gen_function(pool->fns[slot], &pool->outs[slot], pool->format, pool->no_peephole);
+    pthread_mutex_lock(&pool->lock);
+
+    pool->done[slot] = true;
+    pthread_cond_broadcast(&pool->cond);
   }
+  pthread_mutex_unlock(&pool->lock);
+  release_buffers();
+  return NULL;
 }
 
-void codegen(Program *prog) {
-  printf(".intel_syntax noprefix\n");
-  emit_data(prog);
-  emit_text(prog);
+static CodegenPool *new_pool(int nthreads) {
+  CodegenPool *pool = calloc(1, sizeof(CodegenPool));
+  pool->threads = calloc(nthreads, sizeof(pthread_t));
+  pool->cap = nthreads * 4;
+  pool->fns = calloc(pool->cap, sizeof(Function *));
+  pool->outs = calloc(pool->cap, sizeof(Object));
+  pool->format = cc->format;
+  pool->no_peephole = cc->no_peephole;
+  pool->done = calloc(pool->cap, sizeof(bool));
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+
+  while (pool->nthreads < nthreads &&
+         !pthread_create(&pool->threads[pool->nthreads], NULL, codegen_worker, pool))
+    pool->nthreads++;
+  return pool;
 }
+
+// Writes out the oldest function in the window, or discards it if
+// `discard`. Waits for it to be generated if `wait`; otherwise returns
+// false if it is not done yet. Called with the lock held.
+static bool flush_oldest(CodegenPool *pool, bool wait, bool discard) {
+  int slot = pool->flushed % pool->cap;
+  while (!pool->done[slot]) {
+    if (!wait)
+      return false;
+    pthread_cond_wait(&pool->cond, &pool->lock);
+  }
+
+  pthread_mutex_unlock(&pool->lock);
+  if (discard)
+    free_object(&pool->outs[slot]);
+  else
+    flush(&pool->outs[slot]);
+  pthread_mutex_lock(&pool->lock);
+
+  pool->done[slot] = false;
+  pool->flushed++;
+  return true;
+}
+
+// Lets the threads finish what has been queued, writes it out unless
+// `discard`, and frees the pool.
+static void close_pool(CodegenPool *pool, bool discard) {
+  pthread_mutex_lock(&pool->lock);
+  pool->closing = true;
+  pthread_cond_broadcast(&pool->cond);
+  while (pool->flushed < pool->len)
+    flush_oldest(pool, true, discard);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int i = 0; i < pool->nthreads; i++)
+    pthread_join(pool->threads[i], NULL);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->cond);
+  free(pool->threads);
+  free(pool->fns);
+  free(pool->outs);
+  free(pool->done);
+  free(pool);
+}
+
+// Starts the output of a translation unit.
+void codegen_begin(void) {
+  if (cc->format == FMT_ASM) {
+    out = &cc->output.text;
+    emit(".intel_syntax noprefix\n");
+    emit(".text\n");
+  }
+
+  if (cc->codegen_threads > 1)
+    cc->codegen_pool = new_pool(cc->codegen_threads);
+}
+
+// Generates `fn` and releases its arena. Functions must be passed in
+// source order.
+void codegen_function(Function *fn) {
+  CodegenPool *pool = cc->codegen_pool;
+  if (!pool || pool->nthreads == 0) {
+    gen_function(fn, &cc->output, cc->format, cc->no_peephole);
+    if (!is_machine_code(cc->format) && cc->output.text.len >= OUTPUT_CHUNK)
+      write_output();
+    return;
+  }
+
+  // Write out whatever is done, and wait only if the window is full.
+  pthread_mutex_lock(&pool->lock);
+  while (pool->flushed < pool->len &&
+         flush_oldest(pool, pool->len - pool->flushed == pool->cap, false))
+    ;
+  pool->fns[pool->len++ % pool->cap] = fn;
+  pthread_cond_signal(&pool->cond);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+// Finishes the output with the global variables. For an object file,
+// this is when the whole file is written, and for --run when the code is
+// loaded.
+void codegen_end(VarList *globals) {
+  if (cc->codegen_pool)
+    close_pool(cc->codegen_pool, false);
+  cc->codegen_pool = NULL;
+  release_buffers();
+
+  if (cc->format == FMT_OBJ) {
+    write_elf(&cc->output, globals);
+    return;
+  }
+  if (cc->format == FMT_JIT) {
+    jit_load(&cc->output, globals);
+    return;
+  }
+
+  out = &cc->output.text;
+  if (cc->format == FMT_ASM)
+    emit_data(globals);
+  write_output();
+}
+
+// Abandons the output after an error. Functions still being generated
+// are finished, so that their arenas are released, but not written.
+void codegen_cancel(void) {
+  if (cc->codegen_pool)
+    close_pool(cc->codegen_pool, true);
+  cc->codegen_pool = NULL;
+  release_buffers();
+  free_object(&cc->output);
+}
+
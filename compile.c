@@ -0,0 +1,211 @@
+#include "9cc.h"
+
+_Thread_local Compiler *cc;
+
+static void write_file(void *arg, char *buf, size_t len) {
+  fwrite(buf, 1, len, arg);
+}
+
+// Returns a sink that writes to a stdio stream.
+Sink file_sink(FILE *fp) {
+  return (Sink){write_file, fp};
+}
+
+static void write_fd(void *arg, char *buf, size_t len) {
+  int fd = (intptr_t)arg;
+  while (len > 0) {
+    ssize_t n = write(fd, buf, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      error("cannot write output: %s", strerror(errno));
+    buf += n;
+    len -= n;
+  }
+}
+
+// Returns a sink that writes straight to a file descriptor. Codegen
+// already hands over output in large chunks, so there is no point in
+// buffering it again in stdio.
+Sink fd_sink(int fd) {
+  return (Sink){write_fd, (void *)(intptr_t)fd};
+}
+
+// Terminates the `size` bytes at `buf` with "\n\0", which tokenize()
+// relies on. `buf` must have room for two more bytes.
+static char *terminate(char *buf, size_t size) {
+  if (size == 0 || buf[size - 1] != '\n')
+    buf[size++] = '\n';
+  buf[size] = '\0';
+  return buf;
+}
+
+// Reads everything from `fd` into a heap buffer that grows in chunks.
+// Used for stdin, pipes and anything else that cannot be mapped.
+// Returns NULL and sets errno on a read error.
+static char *read_stream(int fd) {
+  size_t cap = 64 * 1024;
+  size_t size = 0;
+  char *buf = malloc(cap);
+
+  for (;;) {
+    if (cap - size < 4096) {
+      cap *= 2;
+      buf = realloc(buf, cap);
+    }
+
+    ssize_t n = read(fd, buf + size, cap - size - 2);
+    if (n == 0)
+      break;
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      free(buf);
+      return NULL;
+    }
+    size += n;
+  }
+
+  cc->input_buf = buf;
+  return terminate(buf, size);
+}
+
+// Maps a regular file of `size` bytes. The file is mapped privately at
+// the start of an anonymous reservation two bytes longer than the file,
+// so the sentinel can be written without touching the file itself or
+// faulting on pages past its end. Returns NULL if mmap is unavailable.
+static char *map_file(int fd, size_t size) {
+  char *buf = mmap(NULL, size + 2, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf == MAP_FAILED)
+    return NULL;
+
+  if (size > 0) {
+    if (mmap(buf, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             fd, 0) == MAP_FAILED) {
+      munmap(buf, size + 2);
+      return NULL;
+    }
+    madvise(buf, size, MADV_SEQUENTIAL);
+  }
+
+  cc->input_map = buf;
+  cc->input_map_len = size + 2;
+  return terminate(buf, size);
+}
+
+// Returns the contents of a given file, or of stdin if `path` is "-".
+// The buffer belongs to the running Compiler.
+static char *read_file(char *path) {
+  if (!strcmp(path, "-")) {
+    char *buf = read_stream(STDIN_FILENO);
+    if (!buf)
+      error("cannot read %s: %s", path, strerror(errno));
+    return buf;
+  }
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    error("cannot open %s: %s", path, strerror(errno));
+
+  struct stat st;
+  char *buf = NULL;
+  if (fstat(fd, &st) == 0) {
+    if (S_ISREG(st.st_mode))
+      buf = map_file(fd, st.st_size);
+    if (!buf)
+      buf = read_stream(fd);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  int err = errno;
+  close(fd);
+  if (!buf)
+    error("cannot read %s: %s", path, strerror(err));
+  return buf;
+}
+
+// Creates a Compiler for one translation unit named `filename`, whose
+// assembly is written to `out`.
+Compiler *new_compiler(char *filename, Sink out) {
+  Compiler *c = calloc(1, sizeof(Compiler));
+  c->filename = filename;
+  c->out = out;
+  c->fn_arena = &c->arena;
+  c->codegen_threads = 1;
+  return c;
+}
+
+// Frees a Compiler and everything it allocated, including its
+// diagnostics.
+void free_compiler(Compiler *c) {
+  if (c->fn_arena != &c->arena)
+    arena_release(c->fn_arena);
+
+  free_object(&c->output);
+  if (c->jit_mem)
+    munmap(c->jit_mem, c->jit_size);
+  free(c->tokens);
+  free(c->intern_map);
+  free(c->var_scope.map);
+  free(c->var_scope.undo);
+  free(c->tag_scope.map);
+  free(c->tag_scope.undo);
+  free(c->literals.map);
+  free(c->literals.undo);
+  free(c->derived_types);
+  free(c->input_buf);
+  if (c->input_map)
+    munmap(c->input_map, c->input_map_len);
+  arena_release(&c->arena);
+  free(c);
+}
+
+// Compiles `input`, or the file named by c->filename if `input` is NULL.
+static int run(Compiler *c, char *input) {
+  Compiler *saved = cc;
+  jmp_buf bail;
+  int status = 0;
+
+  cc = c;
+  c->bail = &bail;
+
+  if (!setjmp(bail)) {
+    c->user_input = input ? input : read_file(c->filename);
+    c->token = tokenize();
+
+    // Each function is generated and released as soon as it is parsed,
+    // so only one function's AST is live at a time.
+    codegen_begin();
+    for (Function *fn; (fn = next_function());)
+      codegen_function(fn);
+    codegen_end(c->globals);
+  } else {
+    codegen_cancel();
+    status = -1;
+  }
+
+  c->bail = NULL;
+  cc = saved;
+  return status;
+}
+
+// The compile_* functions return 0 on success. On failure they return
+// -1, and the reasons are in c->diags.
+
+// Compiles `input`, which must end with "\n\0".
+int compile_input(Compiler *c, char *input) {
+  return run(c, input);
+}
+
+// Compiles `len` bytes of source at `src`, which need not be terminated.
+int compile_buffer(Compiler *c, char *src, size_t len) {
+  char *input = arena_alloc(&c->arena, len + 2);
+  memcpy(input, src, len);
+  return run(c, terminate(input, len));
+}
+
+// Compiles the file named by c->filename, or stdin if it is "-".
+int compile_file(Compiler *c) {
+  return run(c, NULL);
+}
@@ -0,0 +1,165 @@
+#include "9cc.h"
+#include <elf.h>
+
+// Writer for ELF64 relocatable objects, used by -c. Global variables
+// and literals are local, so references to them are relocated against
+// their section's symbol. The functions are global symbols, and so are
+// the external functions they call.
+
+enum {
+  S_NULL,
+  S_TEXT,
+  S_RELA_TEXT,
+  S_RODATA_STR,
+  S_RODATA,
+  S_BSS,
+  S_SYMTAB,
+  S_STRTAB,
+  S_SHSTRTAB,
+  S_NOTE_GNU_STACK,
+  NUM_SECTIONS,
+};
+
+// The symbol table starts with a null symbol and one symbol for each
+// section in SectionKind order. All symbols after them are global.
+static int section_index[] = {S_TEXT, S_RODATA_STR, S_RODATA, S_BSS};
+#define NUM_LOCAL_SYMS 5
+
+static void add_sym(CodeBuf *symtab, CodeBuf *strtab, char *name, int info,
+                    int shndx, int value, int size) {
+  Elf64_Sym sym = {
+    .st_name = name ? strtab->len : 0,
+    .st_info = info,
+    .st_shndx = shndx,
+    .st_value = value,
+    .st_size = size,
+  };
+  if (name)
+    buf_append(strtab, name, strlen(name) + 1);
+  buf_append(symtab, &sym, sizeof(sym));
+}
+
+static void pad_to(CodeBuf *buf, int align) {
+  static char zeros[16];
+  buf_append(buf, zeros, align_to(buf->len, align) - buf->len);
+}
+
+// Writes `obj` and the global variables as an object file to the
+// Compiler's sink.
+void write_elf(Object *obj, VarList *globals) {
+  SymMap syms = {};
+  DataLayout data = {};
+  layout_data(globals, &data, &syms);
+
+  CodeBuf symtab = {};
+  CodeBuf strtab = {};
+  buf_append(&strtab, "", 1);
+  add_sym(&symtab, &strtab, NULL, 0, 0, 0, 0);
+  for (int i = 0; i < SEC_UNDEF; i++)
+    add_sym(&symtab, &strtab, NULL, ELF64_ST_INFO(STB_LOCAL, STT_SECTION),
+            section_index[i], 0, 0);
+
+  int nsyms = NUM_LOCAL_SYMS;
+  for (FuncSym *f = obj->funcs; f < obj->funcs + obj->funcs_len; f++) {
+    add_sym(&symtab, &strtab, f->name, ELF64_ST_INFO(STB_GLOBAL, STT_FUNC),
+            S_TEXT, f->offset, f->size);
+    sym_put(&syms, f->name, SEC_TEXT, f->offset)->index = nsyms++;
+  }
+
+  // Anything else that is referenced is defined elsewhere.
+  CodeBuf rela = {};
+  for (Reloc *r = obj->relocs; r < obj->relocs + obj->relocs_len; r++) {
+    SymRef *ref = sym_get(&syms, r->sym);
+    if (!ref) {
+      add_sym(&symtab, &strtab, r->sym, ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE),
+              SHN_UNDEF, 0, 0);
+      ref = sym_put(&syms, r->sym, SEC_UNDEF, 0);
+      ref->index = nsyms++;
+    }
+
+    // Local data is referenced through its section's symbol.
+    Elf64_Rela rel = {.r_offset = r->offset, .r_addend = r->addend};
+    if (ref->index) {
+      rel.r_info = ELF64_R_INFO(ref->index, r->type);
+    } else {
+      rel.r_info = ELF64_R_INFO(1 + ref->section, r->type);
+      rel.r_addend += ref->val;
+    }
+    buf_append(&rela, &rel, sizeof(rel));
+  }
+
+  char shstrtab[] = "\0.text\0.rela.text\0.rodata.str1.1\0.rodata\0.bss\0"
+                    ".symtab\0.strtab\0.shstrtab\0.note.GNU-stack";
+
+  // Lay out the file: header, section contents, section headers.
+  Elf64_Shdr sh[NUM_SECTIONS] = {};
+  sh[S_TEXT] = (Elf64_Shdr){.sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC | SHF_EXECINSTR,
+                            .sh_addralign = 16};
+  sh[S_RELA_TEXT] = (Elf64_Shdr){.sh_type = SHT_RELA, .sh_flags = SHF_INFO_LINK,
+                                 .sh_link = S_SYMTAB, .sh_info = S_TEXT,
+                                 .sh_addralign = 8, .sh_entsize = sizeof(Elf64_Rela)};
+  sh[S_RODATA_STR] = (Elf64_Shdr){.sh_type = SHT_PROGBITS,
+                                  .sh_flags = SHF_ALLOC | SHF_MERGE | SHF_STRINGS,
+                                  .sh_addralign = 1, .sh_entsize = 1};
+  sh[S_RODATA] = (Elf64_Shdr){.sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC,
+                              .sh_addralign = 1};
+  sh[S_BSS] = (Elf64_Shdr){.sh_type = SHT_NOBITS, .sh_flags = SHF_ALLOC | SHF_WRITE,
+                           .sh_size = data.bss_size, .sh_addralign = data.bss_align};
+  sh[S_SYMTAB] = (Elf64_Shdr){.sh_type = SHT_SYMTAB, .sh_link = S_STRTAB,
+                              .sh_info = NUM_LOCAL_SYMS, .sh_addralign = 8,
+                              .sh_entsize = sizeof(Elf64_Sym)};
+  sh[S_STRTAB] = (Elf64_Shdr){.sh_type = SHT_STRTAB, .sh_addralign = 1};
+  sh[S_SHSTRTAB] = (Elf64_Shdr){.sh_type = SHT_STRTAB, .sh_addralign = 1};
+  sh[S_NOTE_GNU_STACK] = (Elf64_Shdr){.sh_type = SHT_PROGBITS, .sh_addralign = 1};
+
+  CodeBuf *contents[NUM_SECTIONS] = {
+    [S_TEXT] = &obj->text,
+    [S_RELA_TEXT] = &rela,
+    [S_RODATA_STR] = &data.rodata_str,
+    [S_RODATA] = &data.rodata,
+    [S_SYMTAB] = &symtab,
+    [S_STRTAB] = &strtab,
+    [S_SHSTRTAB] = &(CodeBuf){shstrtab, sizeof(shstrtab)},
+  };
+
+  for (int i = 1, name = 1; i < NUM_SECTIONS; i++) {
+    sh[i].sh_name = name;
+    name += strlen(shstrtab + name) + 1;
+  }
+
+  CodeBuf file = {};
+  Elf64_Ehdr eh = {
+    .e_ident = {ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3, ELFCLASS64, ELFDATA2LSB,
+                EV_CURRENT, ELFOSABI_SYSV},
+    .e_type = ET_REL,
+    .e_machine = EM_X86_64,
+    .e_version = EV_CURRENT,
+    .e_ehsize = sizeof(Elf64_Ehdr),
+    .e_shentsize = sizeof(Elf64_Shdr),
+    .e_shnum = NUM_SECTIONS,
+    .e_shstrndx = S_SHSTRTAB,
+  };
+  buf_append(&file, &eh, sizeof(eh));
+
+  for (int i = 1; i < NUM_SECTIONS; i++) {
+    pad_to(&file, sh[i].sh_addralign);
+    sh[i].sh_offset = file.len;
+    if (contents[i]) {
+      sh[i].sh_size = contents[i]->len;
+      buf_append(&file, contents[i]->data, contents[i]->len);
+    }
+  }
+
+  pad_to(&file, 8);
+  ((Elf64_Ehdr *)file.data)->e_shoff = file.len;
+  buf_append(&file, sh, sizeof(sh));
+
+  cc->out.write(cc->out.arg, file.data, file.len);
+
+  free(file.data);
+  free(rela.data);
+  free(symtab.data);
+  free(strtab.data);
+  free_data(&data);
+  free(syms.map);
+}
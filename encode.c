@@ -0,0 +1,376 @@
+#include "9cc.h"
+#include <elf.h>
+
+// Machine code encoder for the instructions codegen.c generates. Jumps
+// to labels are resolved within each function. References to symbols
+// become relocations, which are left to the object file writer and the
+// linker.
+
+// Where a function's labels are, and the jumps still to be patched.
+// Reused from one function to the next.
+typedef struct {
+  int pos;   // offset of the rel32 field in the text
+  int label;
+} Fixup;
+
+static _Thread_local int *label_pos;
+static _Thread_local int label_cap;
+static _Thread_local Fixup *fixups;
+static _Thread_local int fixups_len;
+static _Thread_local int fixups_cap;
+
+static void put8(CodeBuf *buf, int val) {
+  char c = val;
+  buf_append(buf, &c, 1);
+}
+
+static void put32(CodeBuf *buf, int val) {
+  buf_append(buf, &val, 4);
+}
+
+static bool is_imm8(int val) {
+  return -128 <= val && val <= 127;
+}
+
+static void add_reloc(Object *obj, int type, char *sym, int addend) {
+  if (obj->relocs_len == obj->relocs_cap) {
+    obj->relocs_cap = obj->relocs_cap ? obj->relocs_cap * 2 : 64;
+    obj->relocs = realloc(obj->relocs, sizeof(Reloc) * obj->relocs_cap);
+  }
+  obj->relocs[obj->relocs_len++] = (Reloc){obj->text.len, type, sym, addend};
+}
+
+// Encodes an instruction that takes a ModRM byte: an optional REX
+// prefix, `opcode` (two bytes if above 0xff), and then `rm`, a register
+// or memory operand, with `r` in the reg field. `w` selects a 64-bit
+// operand size. Byte registers spl, bpl, sil and dil need a REX prefix
+// even when nothing else does, so that they do not mean ah..bh.
+static void encode_rm(CodeBuf *buf, bool w, int opcode, int r, Operand *rm, bool byte_regs) {
+  int base = rm->reg;
+  int rex = 0x40 | w << 3 | (r >> 3) << 2 | base >> 3;
+  bool force = byte_regs && ((4 <= r && r < 8) || (rm->kind == OPD_REG && 4 <= base && base < 8));
+  if (rex != 0x40 || force)
+    put8(buf, rex);
+
+  if (opcode > 0xff)
+    put8(buf, opcode >> 8);
+  put8(buf, opcode);
+
+  if (rm->kind == OPD_REG) {
+    put8(buf, 0xc0 | (r & 7) << 3 | (base & 7));
+    return;
+  }
+
+  // [rbp] and [r13] have no mod=0 form, and [rsp] and [r12] need a SIB.
+  int disp = rm->val;
+  int mod = (disp == 0 && (base & 7) != RBP) ? 0 : is_imm8(disp) ? 1 : 2;
+  put8(buf, mod << 6 | (r & 7) << 3 | (base & 7));
+  if ((base & 7) == RSP)
+    put8(buf, 0x24);
+  if (mod == 1)
+    put8(buf, disp);
+  else if (mod == 2)
+    put32(buf, disp);
+}
+
+// Operations with the forms "op r/m64, imm" (0x83/0x81 with the given
+// ModRM.reg extension) and "op r/m64, r64"
+static void encode_alu(CodeBuf *buf, int ext, int opcode, Ins *i) {
+  if (i->b.kind == OPD_IMM) {
+    bool short_imm = is_imm8(i->b.val);
+    encode_rm(buf, true, short_imm ? 0x83 : 0x81, ext, &i->a, false);
+    if (short_imm)
+      put8(buf, i->b.val);
+    else
+      put32(buf, i->b.val);
+    return;
+  }
+  encode_rm(buf, true, opcode, i->b.reg, &i->a, false);
+}
+
+static void encode_jump(CodeBuf *buf, int opcode, int label) {
+  if (opcode > 0xff)
+    put8(buf, opcode >> 8);
+  put8(buf, opcode);
+
+  if (fixups_len == fixups_cap) {
+    fixups_cap = fixups_cap ? fixups_cap * 2 : 256;
+    fixups = realloc(fixups, sizeof(Fixup) * fixups_cap);
+  }
+  fixups[fixups_len++] = (Fixup){buf->len, label};
+  put32(buf, 0);
+}
+
+static void encode_ins(Object *obj, Ins *i) {
+  CodeBuf *buf = &obj->text;
+
+  switch (i->kind) {
+  case I_LABEL:
+    label_pos[i->a.val] = buf->len;
+    return;
+  case I_PUSH:
+    if (i->a.kind == OPD_REG) {
+      if (i->a.reg >= R8)
+        put8(buf, 0x41);
+      put8(buf, 0x50 + (i->a.reg & 7));
+    } else if (i->a.kind == OPD_IMM && is_imm8(i->a.val)) {
+      put8(buf, 0x6a);
+      put8(buf, i->a.val);
+    } else if (i->a.kind == OPD_IMM) {
+      put8(buf, 0x68);
+      put32(buf, i->a.val);
+    } else {
+      // The immediate is sign-extended, as the address must be.
+      put8(buf, 0x68);
+      add_reloc(obj, R_X86_64_32S, i->a.sym, 0);
+      put32(buf, 0);
+    }
+    return;
+  case I_POP:
+    if (i->a.reg >= R8)
+      put8(buf, 0x41);
+    put8(buf, 0x58 + (i->a.reg & 7));
+    return;
+  case I_MOV:
+    if (i->a.kind == OPD_MEM) {
+      bool byte = i->a.size == 1;
+      encode_rm(buf, !byte, byte ? 0x88 : 0x89, i->b.reg, &i->a, byte);
+    } else if (i->b.kind == OPD_REG) {
+      encode_rm(buf, true, 0x89, i->b.reg, &i->a, false);
+    } else if (i->b.kind == OPD_MEM) {
+      encode_rm(buf, true, 0x8b, i->a.reg, &i->b, false);
+    } else if (i->b.kind == OPD_SYM) {
+      encode_rm(buf, true, 0xc7, 0, &i->a, false);
+      add_reloc(obj, R_X86_64_32S, i->b.sym, 0);
+      put32(buf, 0);
+    } else {
+      encode_rm(buf, true, 0xc7, 0, &i->a, false);
+      put32(buf, i->b.val);
+    }
+    return;
+  case I_MOVSX:
+    encode_rm(buf, true, 0x0fbe, i->a.reg, &i->b, false);
+    return;
+  case I_MOVZX:
+    encode_rm(buf, true, 0x0fb6, i->a.reg, &i->b, true);
+    return;
+  case I_LEA:
+    encode_rm(buf, true, 0x8d, i->a.reg, &i->b, false);
+    return;
+  case I_ADD:
+    encode_alu(buf, 0, 0x01, i);
+    return;
+  case I_SUB:
+    encode_alu(buf, 5, 0x29, i);
+    return;
+  case I_AND:
+    encode_alu(buf, 4, 0x21, i);
+    return;
+  case I_CMP:
+    encode_alu(buf, 7, 0x39, i);
+    return;
+  case I_IMUL:
+    if (i->b.kind == OPD_IMM && is_imm8(i->b.val)) {
+      encode_rm(buf, true, 0x6b, i->a.reg, &i->a, false);
+      put8(buf, i->b.val);
+    } else if (i->b.kind == OPD_IMM) {
+      encode_rm(buf, true, 0x69, i->a.reg, &i->a, false);
+      put32(buf, i->b.val);
+    } else {
+      encode_rm(buf, true, 0x0faf, i->a.reg, &i->b, false);
+    }
+    return;
+  case I_CQO:
+    put8(buf, 0x48);
+    put8(buf, 0x99);
+    return;
+  case I_IDIV:
+    encode_rm(buf, true, 0xf7, 7, &i->a, false);
+    return;
+  case I_SETE:
+    encode_rm(buf, false, 0x0f94, 0, &i->a, true);
+    return;
+  case I_SETNE:
+    encode_rm(buf, false, 0x0f95, 0, &i->a, true);
+    return;
+  case I_SETL:
+    encode_rm(buf, false, 0x0f9c, 0, &i->a, true);
+    return;
+  case I_SETLE:
+    encode_rm(buf, false, 0x0f9e, 0, &i->a, true);
+    return;
+  case I_SETG:
+    encode_rm(buf, false, 0x0f9f, 0, &i->a, true);
+    return;
+  case I_SETGE:
+    encode_rm(buf, false, 0x0f9d, 0, &i->a, true);
+    return;
+  case I_JMP:
+    encode_jump(buf, 0xe9, i->a.val);
+    return;
+  case I_JE:
+    encode_jump(buf, 0x0f84, i->a.val);
+    return;
+  case I_JNE:
+    encode_jump(buf, 0x0f85, i->a.val);
+    return;
+  case I_JL:
+    encode_jump(buf, 0x0f8c, i->a.val);
+    return;
+  case I_JLE:
+    encode_jump(buf, 0x0f8e, i->a.val);
+    return;
+  case I_JG:
+    encode_jump(buf, 0x0f8f, i->a.val);
+    return;
+  case I_JGE:
+    encode_jump(buf, 0x0f8d, i->a.val);
+    return;
+  case I_CALL:
+    put8(buf, 0xe8);
+    add_reloc(obj, R_X86_64_PLT32, i->a.sym, -4);
+    put32(buf, 0);
+    return;
+  case I_RET:
+    put8(buf, 0xc3);
+    return;
+  }
+}
+
+// Appends the machine code for function `name` to `obj`. Jumps always
+// use a 32-bit displacement, so no relaxation pass is needed.
+void encode_function(char *name, InsList *insns, Object *obj) {
+  int labels = 0;
+  for (Ins *i = insns->data; i < insns->data + insns->len; i++)
+    if (i->kind == I_LABEL && labels <= i->a.val)
+      labels = i->a.val + 1;
+  if (label_cap < labels) {
+    label_cap = labels * 2;
+    label_pos = realloc(label_pos, sizeof(int) * label_cap);
+  }
+
+  int start = obj->text.len;
+  fixups_len = 0;
+  for (Ins *i = insns->data; i < insns->data + insns->len; i++)
+    encode_ins(obj, i);
+
+  for (Fixup *f = fixups; f < fixups + fixups_len; f++) {
+    int rel = label_pos[f->label] - (f->pos + 4);
+    memcpy(obj->text.data + f->pos, &rel, 4);
+  }
+
+  if (obj->funcs_len == obj->funcs_cap) {
+    obj->funcs_cap = obj->funcs_cap ? obj->funcs_cap * 2 : 64;
+    obj->funcs = realloc(obj->funcs, sizeof(FuncSym) * obj->funcs_cap);
+  }
+  obj->funcs[obj->funcs_len++] = (FuncSym){name, start, obj->text.len - start};
+}
+
+// Frees the label and fixup buffers of the calling thread.
+void encode_release(void) {
+  free(label_pos);
+  free(fixups);
+  label_pos = NULL;
+  fixups = NULL;
+  label_cap = fixups_len = fixups_cap = 0;
+}
+
+// Appends the code of `src` to `dst`.
+void merge_object(Object *dst, Object *src) {
+  int base = dst->text.len;
+  buf_append(&dst->text, src->text.data, src->text.len);
+
+  for (int i = 0; i < src->relocs_len; i++) {
+    if (dst->relocs_len == dst->relocs_cap) {
+      dst->relocs_cap = dst->relocs_cap ? dst->relocs_cap * 2 : 64;
+      dst->relocs = realloc(dst->relocs, sizeof(Reloc) * dst->relocs_cap);
+    }
+    Reloc *r = &dst->relocs[dst->relocs_len++];
+    *r = src->relocs[i];
+    r->offset += base;
+  }
+
+  for (int i = 0; i < src->funcs_len; i++) {
+    if (dst->funcs_len == dst->funcs_cap) {
+      dst->funcs_cap = dst->funcs_cap ? dst->funcs_cap * 2 : 64;
+      dst->funcs = realloc(dst->funcs, sizeof(FuncSym) * dst->funcs_cap);
+    }
+    FuncSym *f = &dst->funcs[dst->funcs_len++];
+    *f = src->funcs[i];
+    f->offset += base;
+  }
+}
+
+//
+// Symbols and data
+//
+
+static SymRef *sym_slot(SymRef *map, int cap, char *name) {
+  for (uintptr_t i = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15u >> 32;; i++) {
+    SymRef *e = &map[i & (cap - 1)];
+    if (!e->name || e->name == name)
+      return e;
+  }
+}
+
+SymRef *sym_get(SymMap *m, char *name) {
+  if (!m->cap)
+    return NULL;
+  SymRef *e = sym_slot(m->map, m->cap, name);
+  return e->name ? e : NULL;
+}
+
+SymRef *sym_put(SymMap *m, char *name, SectionKind section, int64_t val) {
+  if (m->used * 2 >= m->cap) {
+    int cap = m->cap ? m->cap * 2 : 256;
+    SymRef *map = calloc(cap, sizeof(SymRef));
+    for (int i = 0; i < m->cap; i++)
+      if (m->map[i].name)
+        *sym_slot(map, cap, m->map[i].name) = m->map[i];
+    free(m->map);
+    m->map = map;
+    m->cap = cap;
+  }
+
+  SymRef *e = sym_slot(m->map, m->cap, name);
+  if (!e->name)
+    m->used++;
+  *e = (SymRef){name, section, val};
+  return e;
+}
+
+// Lays out the global variables as emit_data() in codegen.c does for
+// assembly: literals without an embedded NUL in .rodata.str1.1, other
+// literals in .rodata and the rest in .bss. Records where each one is
+// in `syms`.
+void layout_data(VarList *globals, DataLayout *data, SymMap *syms) {
+  data->bss_align = 1;
+  for (VarList *vl = globals; vl; vl = vl->next) {
+    Var *var = vl->var;
+    if (var->contents && !memchr(var->contents, '\0', var->cont_len - 1)) {
+      sym_put(syms, var->name, SEC_RODATA_STR, data->rodata_str.len);
+      buf_append(&data->rodata_str, var->contents, var->cont_len);
+    } else if (var->contents) {
+      sym_put(syms, var->name, SEC_RODATA, data->rodata.len);
+      buf_append(&data->rodata, var->contents, var->cont_len);
+    } else {
+      data->bss_size = align_to(data->bss_size, var->ty->align);
+      sym_put(syms, var->name, SEC_BSS, data->bss_size);
+      data->bss_size += var->ty->size;
+      if (data->bss_align < var->ty->align)
+        data->bss_align = var->ty->align;
+    }
+  }
+}
+
+void free_data(DataLayout *data) {
+  free(data->rodata_str.data);
+  free(data->rodata.data);
+}
+
+void free_object(Object *obj) {
+  free(obj->text.data);
+  free(obj->relocs);
+  free(obj->funcs);
+  *obj = (Object){};
+}
@@ -0,0 +1,214 @@
+#include "9cc.h"
+
+// Constant folding and algebraic simplification of a function's AST,
+// run on typed trees before they are lowered to IR. Nodes are rewritten
+// in place or replaced by one of their operands, so nothing is
+// allocated.
+
+static Node *fold(Node *node);
+
+static bool is_num(Node *node, int val) {
+  return node->kind == ND_NUM && node->val == val;
+}
+
+// Whether evaluating `node` may do more than compute a value
+static bool has_side_effects(Node *node) {
+  switch (node->kind) {
+  case ND_NULL:
+  case ND_NUM:
+  case ND_VAR:
+    return false;
+  case ND_MEMBER:
+  case ND_ADDR:
+  case ND_DEREF:
+    return has_side_effects(node->lhs);
+  case ND_ADD:
+  case ND_PTR_ADD:
+  case ND_SUB:
+  case ND_PTR_SUB:
+  case ND_PTR_DIFF:
+  case ND_MUL:
+  case ND_DIV:
+  case ND_EQ:
+  case ND_NE:
+  case ND_LT:
+  case ND_LE:
+  case ND_GT:
+  case ND_GE:
+    return has_side_effects(node->lhs) || has_side_effects(node->rhs);
+  default:
+    return true;
+  }
+}
+
+// Turns `node` into the number `val` if it fits in one. Arithmetic is
+// done in 64 bits at run time, so a result that does not fit is left to
+// be computed there.
+static bool set_num(Node *node, long val) {
+  if (val != (int)val)
+    return false;
+  node->kind = ND_NUM;
+  node->ty = int_type;
+  node->val = val;
+  return true;
+}
+
+// Replaces `node` by its operand `op`, which takes its place in a list
+// of statements or arguments.
+static Node *replace(Node *node, Node *op) {
+  op->next = node->next;
+  return op;
+}
+
+// Evaluates the operator of `node` on constant operands.
+static bool fold_num(Node *node, long a, long b) {
+  switch (node->kind) {
+  case ND_ADD:
+    return set_num(node, a + b);
+  case ND_SUB:
+    return set_num(node, a - b);
+  case ND_MUL:
+    return set_num(node, a * b);
+  case ND_DIV:
+    // Division by zero is left to fault at run time.
+    return b && set_num(node, a / b);
+  case ND_EQ:
+    return set_num(node, a == b);
+  case ND_NE:
+    return set_num(node, a != b);
+  case ND_LT:
+    return set_num(node, a < b);
+  case ND_LE:
+    return set_num(node, a <= b);
+  case ND_GT:
+    return set_num(node, a > b);
+  case ND_GE:
+    return set_num(node, a >= b);
+  default:
+    return false;
+  }
+}
+
+static Node *fold_binary(Node *node) {
+  Node *lhs = node->lhs = fold(node->lhs);
+  Node *rhs = node->rhs = fold(node->rhs);
+  if (lhs->kind == ND_NUM && rhs->kind == ND_NUM && fold_num(node, lhs->val, rhs->val))
+    return node;
+
+  // Scale a constant pointer offset now, which leaves a plain add or
+  // subtract of bytes. The node keeps its pointer type.
+  if ((node->kind == ND_PTR_ADD || node->kind == ND_PTR_SUB) && rhs->kind == ND_NUM) {
+    long offset = (long)rhs->val * node->ty->base->size;
+    if (offset == (int)offset) {
+      rhs->val = offset;
+      node->kind = node->kind == ND_PTR_ADD ? ND_ADD : ND_SUB;
+    }
+  }
+
+  switch (node->kind) {
+  case ND_ADD:
+    if (is_num(rhs, 0))
+      return replace(node, lhs);
+    if (is_num(lhs, 0))
+      return replace(node, rhs);
+    return node;
+  case ND_SUB:
+    if (is_num(rhs, 0))
+      return replace(node, lhs);
+    return node;
+  case ND_MUL:
+    if (is_num(rhs, 1))
+      return replace(node, lhs);
+    if (is_num(lhs, 1))
+      return replace(node, rhs);
+    if ((is_num(rhs, 0) && !has_side_effects(lhs)) ||
+        (is_num(lhs, 0) && !has_side_effects(rhs)))
+      set_num(node, 0);
+    return node;
+  case ND_DIV:
+    if (is_num(rhs, 1))
+      return replace(node, lhs);
+    return node;
+  default:
+    return node;
+  }
+}
+
+static Node *fold_list(Node *head) {
+  for (Node **p = &head; *p; p = &(*p)->next)
+    *p = fold(*p);
+  return head;
+}
+
+// Simplifies `node` and returns what replaces it. Statements under a
+// constant condition are pruned down to the branch that runs.
+static Node *fold(Node *node) {
+  switch (node->kind) {
+  case ND_NULL:
+  case ND_NUM:
+  case ND_VAR:
+    return node;
+  case ND_MEMBER:
+  case ND_RETURN:
+  case ND_EXPR_STMT:
+  case ND_ADDR:
+  case ND_DEREF:
+    node->lhs = fold(node->lhs);
+    return node;
+  case ND_ASSIGN:
+    node->lhs = fold(node->lhs);
+    node->rhs = fold(node->rhs);
+    return node;
+  case ND_IF: {
+    node->cond = fold(node->cond);
+    node->then = fold(node->then);
+    if (node->els)
+      node->els = fold(node->els);
+    if (node->cond->kind != ND_NUM)
+      return node;
+
+    Node *taken = node->cond->val ? node->then : node->els;
+    if (taken)
+      return replace(node, taken);
+    node->kind = ND_NULL;
+    return node;
+  }
+  case ND_WHILE:
+  case ND_FOR:
+    if (node->init)
+      node->init = fold(node->init);
+    if (node->cond)
+      node->cond = fold(node->cond);
+    if (node->inc)
+      node->inc = fold(node->inc);
+    node->then = fold(node->then);
+    if (!node->cond || node->cond->kind != ND_NUM)
+      return node;
+
+    // A loop that never runs leaves only its initializer. One that
+    // never ends needs no test, which a "for" can do without.
+    if (!node->cond->val) {
+      if (node->init)
+        return replace(node, node->init);
+      node->kind = ND_NULL;
+      return node;
+    }
+    node->kind = ND_FOR;
+    node->cond = NULL;
+    return node;
+  case ND_BLOCK:
+  case ND_STMT_EXPR:
+    node->body = fold_list(node->body);
+    return node;
+  case ND_FCALL:
+    node->args = fold_list(node->args);
+    return node;
+  default:
+    return fold_binary(node);
+  }
+}
+
+// Folds the statements of `fn`.
+void fold_function(Function *fn) {
+  fn->node = fold_list(fn->node);
+}
@@ -0,0 +1,438 @@
+#include "9cc.h"
+
+// Lowering of a function's AST to IR: basic blocks of three-address
+// instructions over an unlimited supply of virtual registers. Every
+// block ends in exactly one IR_JMP, IR_BR or IR_RET.
+
+// The function being lowered on this thread
+static _Thread_local IrFunction *ir;
+static _Thread_local BasicBlock *cur_bb;
+static _Thread_local BasicBlock *last_bb;
+
+static int lower(Node *node);
+
+static BasicBlock *new_block(void) {
+  BasicBlock *bb = arena_alloc(ir->arena, sizeof(BasicBlock));
+  bb->id = ++ir->nblocks;
+  return bb;
+}
+
+// Makes `bb` the block that instructions are added to, and the next
+// one in the function's layout.
+static void start_block(BasicBlock *bb) {
+  last_bb = last_bb->next = bb;
+  cur_bb = bb;
+}
+
+static IrIns *new_ins(IrOp op) {
+  IrIns *i = arena_alloc(ir->arena, sizeof(IrIns));
+  i->op = op;
+  if (cur_bb->last)
+    cur_bb->last = cur_bb->last->next = i;
+  else
+    cur_bb->ins = cur_bb->last = i;
+  return i;
+}
+
+static int new_reg(void) {
+  return ++ir->nregs;
+}
+
+// Adds `d = a op b` and returns d.
+static int emit3(IrOp op, int a, int b) {
+  IrIns *i = new_ins(op);
+  i->d = new_reg();
+  i->a = a;
+  i->b = b;
+  return i->d;
+}
+
+static int emit_imm(int val) {
+  IrIns *i = new_ins(IR_IMM);
+  i->d = new_reg();
+  i->val = val;
+  return i->d;
+}
+
+static int emit_load(int addr, int size) {
+  IrIns *i = new_ins(IR_LOAD);
+  i->d = new_reg();
+  i->a = addr;
+  i->size = size;
+  return i->d;
+}
+
+static void emit_store(int addr, int val, int size) {
+  IrIns *i = new_ins(IR_STORE);
+  i->a = addr;
+  i->b = val;
+  i->size = size;
+}
+
+static void emit_sext(int d, int a, int size) {
+  IrIns *i = new_ins(IR_SEXT);
+  i->d = d;
+  i->a = a;
+  i->size = size;
+}
+
+// Assigns `val` to the variable in register `d`. Where `val` is a
+// temporary just computed, its instruction is made to write `d`
+// instead.
+static void assign_reg(int d, int val, Type *ty) {
+  if (ty->size == 1) {
+    emit_sext(d, val, 1);
+    return;
+  }
+
+  IrIns *last = cur_bb->last;
+  if (val > ir->nvars && last && last->d == val) {
+    last->d = d;
+    return;
+  }
+
+  IrIns *i = new_ins(IR_MOV);
+  i->d = d;
+  i->a = val;
+}
+
+static void emit_jmp(BasicBlock *bb) {
+  new_ins(IR_JMP)->then = bb;
+}
+
+static void emit_br(int cond, BasicBlock *then, BasicBlock *els) {
+  IrIns *i = new_ins(IR_BR);
+  i->a = cond;
+  i->then = then;
+  i->els = els;
+}
+
+static int lower_addr(Node *node) {
+  switch (node->kind) {
+  case ND_VAR: {
+    Var *var = node->var;
+    IrIns *i = new_ins(var->is_local ? IR_LADDR : IR_GADDR);
+    i->d = new_reg();
+    i->val = var->offset;
+    i->name = var->name;
+    return i->d;
+  }
+  case ND_DEREF:
+    return lower(node->lhs);
+  case ND_MEMBER:
+    return emit3(IR_ADD, lower_addr(node->lhs), emit_imm(node->member->offset));
+  }
+
+  // add_type() rejects anything else.
+  assert(0 && "not an lvalue");
+}
+
+// Loads a value of type `ty` from `addr`. An array is not loaded: its
+// value is its address.
+static int load(int addr, Type *ty) {
+  if (ty->kind == TY_ARRAY)
+    return addr;
+  return emit_load(addr, ty->size);
+}
+
+static int lower_call(Node *node) {
+  int nargs = 0;
+  for (Node *arg = node->args; arg; arg = arg->next)
+    nargs++;
+
+  int *args = arena_alloc(ir->arena, sizeof(int) * nargs);
+  nargs = 0;
+  for (Node *arg = node->args; arg; arg = arg->next)
+    args[nargs++] = lower(arg);
+
+  IrIns *i = new_ins(IR_CALL);
+  i->d = new_reg();
+  i->name = node->funcname;
+  i->args = args;
+  i->nargs = nargs;
+  return i->d;
+}
+
+// Adds the code for `node` and returns the register that holds its
+// value, or 0 for a statement.
+static int lower(Node *node) {
+  switch (node->kind) {
+  case ND_NULL:
+    return 0;
+  case ND_NUM:
+    return emit_imm(node->val);
+  case ND_EXPR_STMT:
+    lower(node->lhs);
+    return 0;
+  case ND_VAR:
+    if (node->var->reg)
+      return node->var->reg;
+    return load(lower_addr(node), node->ty);
+  case ND_MEMBER:
+    return load(lower_addr(node), node->ty);
+  case ND_ASSIGN: {
+    if (node->lhs->kind == ND_VAR && node->lhs->var->reg) {
+      int reg = node->lhs->var->reg;
+      assign_reg(reg, lower(node->rhs), node->ty);
+      return reg;
+    }
+
+    int addr = lower_addr(node->lhs);
+    int val = lower(node->rhs);
+    emit_store(addr, val, node->ty->size);
+    return val;
+  }
+  case ND_ADDR:
+    return lower_addr(node->lhs);
+  case ND_DEREF:
+    return load(lower(node->lhs), node->ty);
+  case ND_IF: {
+    BasicBlock *then = new_block();
+    BasicBlock *els = new_block();
+    BasicBlock *end = node->els ? new_block() : els;
+
+    emit_br(lower(node->cond), then, els);
+    start_block(then);
+    lower(node->then);
+    emit_jmp(end);
+    if (node->els) {
+      start_block(els);
+      lower(node->els);
+      emit_jmp(end);
+    }
+    start_block(end);
+    return 0;
+  }
+  case ND_WHILE:
+  case ND_FOR: {
+    BasicBlock *begin = new_block();
+    BasicBlock *body = new_block();
+    BasicBlock *end = new_block();
+
+    if (node->kind == ND_FOR && node->init)
+      lower(node->init);
+    emit_jmp(begin);
+    start_block(begin);
+    if (node->kind == ND_WHILE || node->cond)
+      emit_br(lower(node->cond), body, end);
+    else
+      emit_jmp(body);
+    start_block(body);
+    lower(node->then);
+    if (node->kind == ND_FOR && node->inc)
+      lower(node->inc);
+    emit_jmp(begin);
+    start_block(end);
+    return 0;
+  }
+  case ND_BLOCK:
+  case ND_STMT_EXPR: {
+    // The value of a statement expression is that of its last node.
+    int val = 0;
+    for (Node *n = node->body; n; n = n->next)
+      val = lower(n);
+    return val;
+  }
+  case ND_FCALL:
+    return lower_call(node);
+  case ND_RETURN: {
+    int val = lower(node->lhs);
+    new_ins(IR_RET)->a = val;
+    start_block(new_block());
+    return 0;
+  }
+  }
+
+  int lhs = lower(node->lhs);
+  int rhs = lower(node->rhs);
+
+  switch (node->kind) {
+  case ND_ADD:
+    return emit3(IR_ADD, lhs, rhs);
+  case ND_PTR_ADD:
+    return emit3(IR_ADD, lhs, emit3(IR_MUL, rhs, emit_imm(node->ty->base->size)));
+  case ND_SUB:
+    return emit3(IR_SUB, lhs, rhs);
+  case ND_PTR_SUB:
+    return emit3(IR_SUB, lhs, emit3(IR_MUL, rhs, emit_imm(node->ty->base->size)));
+  case ND_PTR_DIFF:
+    return emit3(IR_DIV, emit3(IR_SUB, lhs, rhs), emit_imm(node->lhs->ty->base->size));
+  case ND_MUL:
+    return emit3(IR_MUL, lhs, rhs);
+  case ND_DIV:
+    return emit3(IR_DIV, lhs, rhs);
+  case ND_EQ:
+    return emit3(IR_EQ, lhs, rhs);
+  case ND_NE:
+    return emit3(IR_NE, lhs, rhs);
+  case ND_LT:
+    return emit3(IR_LT, lhs, rhs);
+  case ND_LE:
+    return emit3(IR_LE, lhs, rhs);
+  case ND_GT:
+    return emit3(IR_LT, rhs, lhs);
+  case ND_GE:
+    return emit3(IR_LE, rhs, lhs);
+  }
+
+  assert(0 && "unknown node");
+}
+
+// A local variable can live in a virtual register if nothing but its
+// own name can refer to it: it must be a scalar whose address is never
+// taken.
+static bool is_promotable(Var *var) {
+  return !var->addr_taken && (is_integer(var->ty) || var->ty->kind == TY_PTR);
+}
+
+// Lowers `fn` to IR allocated in the function's arena. Variables that
+// can live in registers get one each, and the rest are given offsets in
+// the stack frame.
+IrFunction *lower_function(Function *fn) {
+  ir = arena_alloc(&fn->arena, sizeof(IrFunction));
+  ir->name = fn->name;
+  ir->arena = &fn->arena;
+
+  // Parameter i arrives in virtual register i+1. That is the variable's
+  // own register if it can have one.
+  int nparams = 0;
+  for (VarList *vl = fn->params; vl; vl = vl->next) {
+    int r = new_reg();
+    if (is_promotable(vl->var))
+      vl->var->reg = r;
+    nparams++;
+  }
+
+  // A promoted variable still gets a slot in the frame, unused, so that
+  // the layout of the others does not depend on which are promoted.
+  int offset = 0;
+  for (VarList *vl = fn->locals; vl; vl = vl->next) {
+    Var *var = vl->var;
+    if (!var->reg && is_promotable(var))
+      var->reg = new_reg();
+    offset = align_to(offset, var->ty->align);
+    offset += var->ty->size;
+    var->offset = offset;
+  }
+  ir->stack_size = align_to(offset, 8);
+  ir->nvars = ir->nregs;
+
+  BasicBlock head = {};
+  last_bb = &head;
+  start_block(new_block());
+
+  // The IR_PARAMs come first, so that the backend can take all the
+  // arguments out of their registers at once.
+  for (int i = 0; i < nparams; i++) {
+    IrIns *param = new_ins(IR_PARAM);
+    param->d = i + 1;
+    param->val = i;
+  }
+
+  // A char argument is only defined in its low byte.
+  int idx = 0;
+  for (VarList *vl = fn->params; vl; vl = vl->next) {
+    Var *var = vl->var;
+    idx++;
+    if (var->reg) {
+      if (var->ty->size == 1)
+        emit_sext(var->reg, var->reg, 1);
+      continue;
+    }
+
+    IrIns *addr = new_ins(IR_LADDR);
+    addr->d = new_reg();
+    addr->val = var->offset;
+    emit_store(addr->d, idx, var->ty->size);
+  }
+
+  for (Node *node = fn->node; node; node = node->next)
+    lower(node);
+
+  // Falling off the end returns whatever is in the return register.
+  new_ins(IR_RET);
+
+  ir->blocks = head.next;
+  return ir;
+}
+
+//
+// IR dump for --dump-ir
+//
+
+static char *op_names[] = {
+  [IR_IMM] = "imm", [IR_MOV] = "mov", [IR_SEXT] = "sext", [IR_ADD] = "add",
+  [IR_SUB] = "sub", [IR_MUL] = "mul", [IR_DIV] = "div", [IR_EQ] = "eq",
+  [IR_NE] = "ne", [IR_LT] = "lt", [IR_LE] = "le", [IR_LADDR] = "laddr",
+  [IR_GADDR] = "gaddr", [IR_LOAD] = "load", [IR_STORE] = "store",
+  [IR_PARAM] = "param", [IR_CALL] = "call", [IR_JMP] = "jmp", [IR_BR] = "br",
+  [IR_RET] = "ret",
+};
+
+static void dump(CodeBuf *buf, char *fmt, ...) {
+  char tmp[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int len = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+  va_end(ap);
+  buf_append(buf, tmp, len < sizeof(tmp) ? len : sizeof(tmp) - 1);
+}
+
+static void dump_ins(CodeBuf *buf, IrIns *i) {
+  dump(buf, "  ");
+  if (i->d)
+    dump(buf, "r%d = ", i->d);
+  dump(buf, "%s", op_names[i->op]);
+
+  switch (i->op) {
+  case IR_IMM:
+  case IR_PARAM:
+    dump(buf, " %d", i->val);
+    break;
+  case IR_LADDR:
+    dump(buf, " [rbp-%d]", i->val);
+    break;
+  case IR_GADDR:
+    dump(buf, " %s", i->name);
+    break;
+  case IR_SEXT:
+  case IR_LOAD:
+    dump(buf, "%d r%d", i->size * 8, i->a);
+    break;
+  case IR_STORE:
+    dump(buf, "%d r%d, r%d", i->size * 8, i->a, i->b);
+    break;
+  case IR_CALL:
+    dump(buf, " %s(", i->name);
+    for (int j = 0; j < i->nargs; j++)
+      dump(buf, j ? ", r%d" : "r%d", i->args[j]);
+    dump(buf, ")");
+    break;
+  case IR_JMP:
+    dump(buf, " bb%d", i->then->id);
+    break;
+  case IR_BR:
+    dump(buf, " r%d, bb%d, bb%d", i->a, i->then->id, i->els->id);
+    break;
+  case IR_RET:
+    if (i->a)
+      dump(buf, " r%d", i->a);
+    break;
+  default:
+    dump(buf, " r%d", i->a);
+    if (i->b)
+      dump(buf, ", r%d", i->b);
+  }
+  dump(buf, "\n");
+}
+
+// Appends a human-readable listing of `fn` to `buf`.
+void dump_ir(IrFunction *fn, CodeBuf *buf) {
+  dump(buf, "%s:\n", fn->name);
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+    dump(buf, "bb%d:\n", bb->id);
+    for (IrIns *i = bb->ins; i; i = i->next)
+      dump_ins(buf, i);
+  }
+  dump(buf, "\n");
+}
@@ -0,0 +1,101 @@
+#include "9cc.h"
+#include <dlfcn.h>
+#include <elf.h>
+
+// In-process execution for --run. The machine code and data of a
+// translation unit are loaded into memory mapped in the low 2 GiB, so
+// that the 32-bit absolute addresses codegen uses for globals stay
+// valid. Calls to functions outside the translation unit are resolved
+// in the host process with dlsym. The host's libraries are too far
+// away for a 32-bit displacement, so those calls go through stubs.
+
+// A stub is "jmp [rip+0]" followed by the target address.
+#define STUB_SIZE 16
+
+static void write_stub(char *p, void *addr) {
+  static char jmp[] = {0xff, 0x25, 0, 0, 0, 0};
+  memcpy(p, jmp, sizeof(jmp));
+  memcpy(p + sizeof(jmp), &addr, 8);
+}
+
+// Loads `obj` and the global variables into memory and records where
+// the translation unit's main() is.
+void jit_load(Object *obj, VarList *globals) {
+  SymMap syms = {};
+  DataLayout data = {};
+  layout_data(globals, &data, &syms);
+  for (FuncSym *f = obj->funcs; f < obj->funcs + obj->funcs_len; f++)
+    sym_put(&syms, f->name, SEC_TEXT, f->offset);
+
+  // Everything else gets a stub, numbered by `index`.
+  int nstubs = 0;
+  for (Reloc *r = obj->relocs; r < obj->relocs + obj->relocs_len; r++)
+    if (!sym_get(&syms, r->sym))
+      sym_put(&syms, r->sym, SEC_UNDEF, 0)->index = nstubs++;
+
+  // Text and stubs, read-only data and .bss each start on a new page,
+  // so that each can have its own protection.
+  int page = sysconf(_SC_PAGESIZE);
+  int stubs_off = obj->text.len;
+  int rodata_off = align_to(stubs_off + nstubs * STUB_SIZE, page);
+  int bss_off = align_to(rodata_off + data.rodata_str.len + data.rodata.len, page);
+  int size = align_to(bss_off + data.bss_size, page);
+
+  char *mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  if (mem == MAP_FAILED)
+    error("cannot map memory: %s", strerror(errno));
+  cc->jit_mem = mem;
+  cc->jit_size = size;
+
+  char *base[] = {
+    [SEC_TEXT] = mem,
+    [SEC_RODATA_STR] = mem + rodata_off,
+    [SEC_RODATA] = mem + rodata_off + data.rodata_str.len,
+    [SEC_BSS] = mem + bss_off,
+    [SEC_UNDEF] = mem + stubs_off,
+  };
+  memcpy(base[SEC_TEXT], obj->text.data, obj->text.len);
+  memcpy(base[SEC_RODATA_STR], data.rodata_str.data, data.rodata_str.len);
+  memcpy(base[SEC_RODATA], data.rodata.data, data.rodata.len);
+
+  for (SymRef *e = syms.map; e < syms.map + syms.cap; e++) {
+    if (!e->name || e->section != SEC_UNDEF)
+      continue;
+    void *addr = dlsym(RTLD_DEFAULT, e->name);
+    if (!addr)
+      error("undefined symbol: %s", e->name);
+    e->val = e->index * STUB_SIZE;
+    write_stub(base[SEC_UNDEF] + e->val, addr);
+  }
+
+  for (Reloc *r = obj->relocs; r < obj->relocs + obj->relocs_len; r++) {
+    SymRef *ref = sym_get(&syms, r->sym);
+    int64_t val = (intptr_t)base[ref->section] + ref->val + r->addend;
+    if (r->type == R_X86_64_PLT32)
+      val -= (intptr_t)mem + r->offset;
+    assert(val == (int32_t)val);
+
+    int32_t field = val;
+    memcpy(mem + r->offset, &field, 4);
+  }
+
+  if (mprotect(mem, rodata_off, PROT_READ | PROT_EXEC) ||
+      mprotect(mem + rodata_off, bss_off - rodata_off, PROT_READ))
+    error("cannot protect memory: %s", strerror(errno));
+
+  SymRef *main_ref = sym_get(&syms, intern("main", 4));
+  if (!main_ref || main_ref->section != SEC_TEXT)
+    error("main is not defined");
+  cc->jit_main = mem + main_ref->val;
+
+  free_data(&data);
+  free(syms.map);
+}
+
+// Calls main() of a Compiler that has compiled for --run, and returns
+// what it returns.
+int jit_run(Compiler *c, int argc, char **argv) {
+  int (*main_fn)(int, char **) = (int (*)(int, char **))c->jit_main;
+  return main_fn(argc, argv);
+}
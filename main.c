@@ -1,45 +1,313 @@
 #include "9cc.h"
 
-// Returns the contents of a given file.
-static char *read_file(char *path) {
-  // Open and read the file.
-  FILE *fp = fopen(path, "r");
-  if (!fp)
-    error("cannot open %s: %s", path, strerror(errno));
-
-  int filemax = 10 * 1024 * 1024;
-  char *buf = malloc(filemax);
-  int size = fread(buf, 1, filemax - 2, fp);
-  if (!feof(fp))
-    error("%s: file is too large");
-
-  // Make sure that the string ends with "\n\0.
-  if (size == 0 || buf[size - 1] != '\n')
-    buf[size++] = '\n';
-  buf[size] = '\0';
+static char *opt_o;
+static int opt_j = 1;
+static int opt_codegen_threads = 1;
+static char *opt_serve;
+static char *opt_client;
+static bool opt_stats;
+static bool opt_c;
+static bool opt_dump_ir;
+static bool opt_no_peephole;
+static char *opt_run;
+static char **run_argv;
+static int run_argc;
+static char **input_paths;
+static int input_len;
+
+static void usage(void) {
+  error("usage: 9cc [-c | --dump-ir] [--no-peephole] [-j N] [--codegen-threads N]\n"
+        "           [-o PATH] FILE...\n"
+        "       9cc --serve SOCKET\n"
+        "       9cc --client SOCKET [-o PATH] FILE\n"
+        "       9cc --client SOCKET --stats\n"
+        "       9cc [--no-peephole] [--codegen-threads N] --run FILE [ARG...]\n"
+        "  -o PATH          write assembly to PATH instead of stdout; with\n"
+        "                   several input files, PATH is a directory\n"
+        "  -c               write an object file instead of assembly, to\n"
+        "                   FILE.o unless -o is given\n"
+        "  --dump-ir        write the IR of each function instead of assembly\n"
+        "  --no-peephole    leave out the peephole optimizer\n"
+        "  -j N             compile up to N files concurrently\n"
+        "  --codegen-threads N\n"
+        "                   generate the functions of a file on N threads\n"
+        "  --serve SOCKET   run a compile server on a Unix socket\n"
+        "  --client SOCKET  have the server at SOCKET do the compilation\n"
+        "  --stats          print the server's request counters\n"
+        "  --run FILE [ARG...]\n"
+        "                   compile FILE in memory and call its main() with\n"
+        "                   FILE and ARGs as argv");
+}
+
+static void parse_args(int argc, char **argv) {
+  input_paths = calloc(argc, sizeof(char *));
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-o")) {
+      if (++i == argc)
+        usage();
+      opt_o = argv[i];
+      continue;
+    }
+
+    if (!strcmp(argv[i], "-j")) {
+      if (++i == argc)
+        usage();
+      opt_j = atoi(argv[i]);
+      if (opt_j < 1)
+        usage();
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--codegen-threads")) {
+      if (++i == argc)
+        usage();
+      opt_codegen_threads = atoi(argv[i]);
+      if (opt_codegen_threads < 1)
+        usage();
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--serve") || !strcmp(argv[i], "--client")) {
+      if (i + 1 == argc)
+        usage();
+      if (argv[i][2] == 's')
+        opt_serve = argv[++i];
+      else
+        opt_client = argv[++i];
+      continue;
+    }
+
+    // Everything after --run FILE belongs to the program.
+    if (!strcmp(argv[i], "--run")) {
+      if (i + 1 == argc)
+        usage();
+      opt_run = argv[i + 1];
+      run_argv = argv + i + 1;
+      run_argc = argc - i - 1;
+      break;
+    }
+
+    if (!strcmp(argv[i], "-c")) {
+      opt_c = true;
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--dump-ir")) {
+      opt_dump_ir = true;
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--no-peephole")) {
+      opt_no_peephole = true;
+      continue;
+    }
+
+    if (!strcmp(argv[i], "--stats")) {
+      opt_stats = true;
+      continue;
+    }
+
+    // "-" alone means stdin.
+    if (argv[i][0] == '-' && argv[i][1])
+      usage();
+    input_paths[input_len++] = argv[i];
+  }
+
+  if (opt_serve) {
+    if (input_len || opt_client || opt_stats)
+      usage();
+    return;
+  }
+
+  if (opt_run) {
+    if (input_len || opt_o || opt_c || opt_dump_ir || opt_client || opt_stats)
+      usage();
+    return;
+  }
+
+  if (opt_client) {
+    if (opt_c || opt_dump_ir || opt_no_peephole || (opt_stats ? input_len != 0 : input_len != 1))
+      usage();
+    return;
+  }
+
+  if (input_len == 0 || opt_stats || (opt_c && opt_dump_ir))
+    usage();
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void print_diags(Compiler *c) {
+  flockfile(stderr);
+  for (Diag *diag = c->diags; diag; diag = diag->next)
+    fprintf(stderr, "%s\n", diag->msg);
+  funlockfile(stderr);
+}
+
+// Compiles `path` to `out_path`, or to stdout if `out_path` is NULL.
+// Diagnostics are printed to stderr. Returns 0 on success.
+static int compile_to(char *path, char *out_path) {
+  int fd = out_path ? open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0666) : STDOUT_FILENO;
+  if (fd < 0) {
+    fprintf(stderr, "cannot open %s: %s\n", out_path, strerror(errno));
+    return -1;
+  }
+
+  Compiler *c = new_compiler(path, fd_sink(fd));
+  c->codegen_threads = opt_codegen_threads;
+  c->format = opt_c ? FMT_OBJ : opt_dump_ir ? FMT_IR : FMT_ASM;
+  c->no_peephole = opt_no_peephole;
+  int status = compile_file(c);
+  print_diags(c);
+  free_compiler(c);
+
+  if (out_path && close(fd)) {
+    fprintf(stderr, "cannot write %s: %s\n", out_path, strerror(errno));
+    status = -1;
+  }
+  if (status && out_path)
+    unlink(out_path);
+  return status;
+}
+
+// Compiles `path` into this process and runs it. Returns the exit
+// status of main(), or 1 if the compilation failed.
+static int run_file(char *path) {
+  Compiler *c = new_compiler(path, (Sink){});
+  c->codegen_threads = opt_codegen_threads;
+  c->format = FMT_JIT;
+  c->no_peephole = opt_no_peephole;
+  int status = compile_file(c);
+  print_diags(c);
+
+  if (!status) {
+    status = jit_run(c, run_argc, run_argv);
+  } else {
+    status = 1;
+  }
+  free_compiler(c);
+  return status;
+}
+
+//
+// Batch mode: several translation units compiled concurrently by a
+// pool of threads, each unit with its own Compiler and output file.
+//
+
+typedef struct {
+  char *path;
+  char *out_path;
+  int status;
+  double time;
+} Unit;
+
+static Unit *units;
+static int next_unit;
+
+// Returns "<dir>/<basename of path without .c><ext>".
+static char *output_path(char *dir, char *path, char *ext) {
+  char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+  int len = strlen(base);
+  if (len > 2 && !strcmp(base + len - 2, ".c"))
+    len -= 2;
+
+  char *buf;
+  if (asprintf(&buf, "%s/%.*s%s", dir, len, base, ext) < 0)
+    error("out of memory");
   return buf;
 }
 
+static int by_out_path(const void *a, const void *b) {
+  return strcmp(((Unit *)a)->out_path, ((Unit *)b)->out_path);
+}
+
+// Fails if two inputs would be written to the same output file, as
+// "a/x.c b/x.c" would, rather than let two threads write it at once.
+static void check_out_paths(void) {
+  Unit *sorted = malloc(sizeof(Unit) * input_len);
+  memcpy(sorted, units, sizeof(Unit) * input_len);
+  qsort(sorted, input_len, sizeof(Unit), by_out_path);
+
+  for (int i = 1; i < input_len; i++)
+    if (!strcmp(sorted[i - 1].out_path, sorted[i].out_path))
+      error("%s and %s would both be written to %s", sorted[i - 1].path,
+            sorted[i].path, sorted[i].out_path);
+  free(sorted);
+}
+
+static void *batch_worker(void *arg) {
+  for (;;) {
+    int i = __atomic_fetch_add(&next_unit, 1, __ATOMIC_RELAXED);
+    if (i >= input_len)
+      return NULL;
+
+    Unit *u = &units[i];
+    double start = now();
+    u->status = compile_to(u->path, u->out_path);
+    u->time = now() - start;
+  }
+}
+
+static int compile_batch(void) {
+  if (!opt_o)
+    error("-o DIR is required when compiling several files");
+
+  units = calloc(input_len, sizeof(Unit));
+  for (int i = 0; i < input_len; i++) {
+    units[i].path = input_paths[i];
+    units[i].out_path = output_path(opt_o, input_paths[i],
+                                   opt_c ? ".o" : opt_dump_ir ? ".ir" : ".s");
+  }
+  check_out_paths();
+
+  int nthreads = opt_j < input_len ? opt_j : input_len;
+  pthread_t *threads = calloc(nthreads, sizeof(pthread_t));
+  double start = now();
+
+  for (int i = 0; i < nthreads; i++)
+    if (pthread_create(&threads[i], NULL, batch_worker, NULL))
+      error("cannot create thread: %s", strerror(errno));
+  for (int i = 0; i < nthreads; i++)
+    pthread_join(threads[i], NULL);
+
+  double wall = now() - start;
+
+  // Report timings in command-line order.
+  double total = 0;
+  int failed = 0;
+  for (int i = 0; i < input_len; i++) {
+    Unit *u = &units[i];
+    fprintf(stderr, "%s: %.3f s%s\n", u->path, u->time, u->status ? " (failed)" : "");
+    total += u->time;
+    failed += u->status != 0;
+  }
+  fprintf(stderr, "%d files, %d threads: %.3f s wall, %.3f s compiling\n",
+          input_len, nthreads, wall, total);
+  return failed ? 1 : 0;
+}
+
 int main(int argc, char **argv) {
-  if (argc != 2)
-    error("%s: wrong number of arguments", argv[0]);
-
-  // Tokenize and Parse
-  filename = argv[1];
-  user_input = read_file(filename);
-  token = tokenize();
-  Program *prog = program();
-
-  for (Function *fn = prog->fns; fn; fn = fn->next) {
-    int offset = 0;
-    for (VarList *vl = fn->locals; vl; vl = vl->next) {
-      Var *var = vl->var;
-      offset = align_to(offset, var->ty->align);
-      offset += var->ty->size;
-      var->offset = offset;
-    }
-    fn->stack_size = align_to(offset, 8);
-  }
-  codegen(prog);
-  return 0;
+  parse_args(argc, argv);
+
+  if (opt_serve)
+    return serve(opt_serve);
+  if (opt_client)
+    return client(opt_client, opt_stats ? NULL : input_paths[0], opt_o);
+  if (opt_run)
+    return run_file(opt_run);
+
+  if (input_len > 1)
+    return compile_batch();
+
+  // Like cc -c, put the object file in the current directory by default.
+  char *out_path = opt_o;
+  if (opt_c && !out_path)
+    out_path = output_path(".", input_paths[0], ".o");
+  return compile_to(input_paths[0], out_path) ? 1 : 0;
 }
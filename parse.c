@@ -1,57 +1,112 @@
 #include "9cc.h"
 
-
-// Scope for struct tags
-typedef struct TagScope TagScope;
-struct TagScope {
-  TagScope *next;
-  char *name;
-  Type *ty;
-};
-
+// Names are resolved through ScopeMaps. Each insertion records the
+// binding it shadows in an undo log, and leaving a scope replays the
+// log back to the depth it had on entry, so lookup, insertion and
+// scope exit are all O(1) per name.
 typedef struct {
-  VarList *var_scope;
-  TagScope *tag_scope;
+  int var_depth;
+  int tag_depth;
 } Scope;
 
-static VarList *locals;
-static VarList *globals;
-static VarList *var_scope;
-static TagScope *tag_scope;
+static ScopeEntry *scope_slot(ScopeEntry *map, int cap, char *name) {
+  for (uintptr_t i = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15u >> 32;; i++) {
+    ScopeEntry *e = &map[i & (cap - 1)];
+    if (!e->name || e->name == name)
+      return e;
+  }
+}
+
+static void *scope_get(ScopeMap *m, char *name) {
+  if (!m->cap)
+    return NULL;
+  return scope_slot(m->map, m->cap, name)->val;
+}
+
+static void scope_put(ScopeMap *m, char *name, void *val) {
+  if (m->used * 2 >= m->cap) {
+    int cap = m->cap ? m->cap * 2 : 256;
+    ScopeEntry *map = calloc(cap, sizeof(ScopeEntry));
+    for (int i = 0; i < m->cap; i++)
+      if (m->map[i].name)
+        *scope_slot(map, cap, m->map[i].name) = m->map[i];
+    free(m->map);
+    m->map = map;
+    m->cap = cap;
+  }
+
+  ScopeEntry *e = scope_slot(m->map, m->cap, name);
+  if (!e->name) {
+    e->name = name;
+    m->used++;
+  }
+
+  if (m->undo_len == m->undo_cap) {
+    m->undo_cap = m->undo_cap ? m->undo_cap * 2 : 256;
+    m->undo = realloc(m->undo, sizeof(ScopeEntry) * m->undo_cap);
+  }
+  m->undo[m->undo_len++] = (ScopeEntry){name, e->val};
+  e->val = val;
+}
+
+static void scope_rollback(ScopeMap *m, int depth) {
+  while (m->undo_len > depth) {
+    ScopeEntry *u = &m->undo[--m->undo_len];
+    scope_slot(m->map, m->cap, u->name)->val = u->val;
+  }
+}
 
 // Begin a block scope
-static Scope *enter_scope(void) {
-  Scope *sc = calloc(1, sizeof(Scope));
-  sc->var_scope = var_scope;
-  sc->tag_scope = tag_scope;
-  return sc;
+static Scope enter_scope(void) {
+  return (Scope){cc->var_scope.undo_len, cc->tag_scope.undo_len};
 }
 
 // End a block scope
-static void leave_scope(Scope *sc) {
-  var_scope = sc->var_scope;
-  tag_scope = sc->tag_scope;
+static void leave_scope(Scope sc) {
+  scope_rollback(&cc->var_scope, sc.var_depth);
+  scope_rollback(&cc->tag_scope, sc.tag_depth);
 }
+
 // Find a variable by name.
 static Var *find_var(Token *tok) {
-  for (VarList *vl = var_scope; vl; vl = vl->next) {
-    Var *var = vl->var;
-    if (strlen(var->name) == tok->len && !strncmp(tok->str, var->name, tok->len))
-      return var;
+  return scope_get(&cc->var_scope, tok->name);
+}
+
+// Find a struct tag by name.
+static Type *find_tag(Token *tok) {
+  return scope_get(&cc->tag_scope, tok->name);
+}
+
+// Returns the number of bytes a node of a given kind needs.
+static size_t node_size(NodeKind kind) {
+  switch (kind) {
+  case ND_NULL:
+    return offsetof(Node, lhs);
+  case ND_NUM:
+    return offsetof(Node, val) + sizeof(int);
+  case ND_VAR:
+    return offsetof(Node, var) + sizeof(Var *);
+  case ND_BLOCK:
+  case ND_STMT_EXPR:
+    return offsetof(Node, body) + sizeof(Node *);
+  case ND_FCALL:
+    return offsetof(Node, args) + sizeof(Node *);
+  case ND_IF:
+  case ND_WHILE:
+  case ND_FOR:
+    return offsetof(Node, inc) + sizeof(Node *);
+  case ND_RETURN:
+  case ND_EXPR_STMT:
+  case ND_ADDR:
+  case ND_DEREF:
+    return offsetof(Node, lhs) + sizeof(Node *);
+  default:
+    return offsetof(Node, rhs) + sizeof(Node *);
   }
-  return NULL;
-}
-
-static TagScope *find_tag(Token *tok) {
-  for (TagScope *sc = tag_scope; sc; sc = sc->next)
-    if (strlen(sc->name) == tok->len && !strncmp(tok->str, sc->name, tok->len))
-      return sc;
-  return NULL;
 }
 
-
 static Node *new_node(NodeKind kind, Token *tok) {
-  Node *node = calloc(1, sizeof(Node));
+  Node *node = arena_alloc(cc->fn_arena, node_size(kind));
   node->kind = kind;
   node->tok = tok;
   return node;
@@ -83,49 +138,44 @@ static Node *new_var_node(Var *var, Token *tok) {
 }
 
 static Var *new_var(char *name, Type *ty, bool is_local) {
-  Var *var = calloc(1, sizeof(Var));
+  Var *var = arena_alloc(is_local ? cc->fn_arena : &cc->arena, sizeof(Var));
   var->name = name;
   var->ty = ty;
   var->is_local = is_local;
-
-  VarList *sc = calloc(1, sizeof(VarList));
-  sc->var = var;
-  sc->next = var_scope;
-  var_scope = sc;
+  scope_put(&cc->var_scope, name, var);
   return var;
 }
 
 static Var *new_lvar(char *name, Type *ty) {
   Var *var = new_var(name, ty, true);
-  VarList *vl = calloc(1, sizeof(VarList));
+  VarList *vl = arena_alloc(cc->fn_arena, sizeof(VarList));
   vl->var = var;
-  vl->next = locals;
-  locals = vl;
+  vl->next = cc->locals;
+  cc->locals = vl;
   return var;
 }
 
 static Var *new_gvar(char *name, Type *ty) {
   Var *var = new_var(name, ty, false);
 
-  VarList *vl = calloc(1, sizeof(VarList));
+  VarList *vl = arena_alloc(&cc->arena, sizeof(VarList));
   vl->var = var;
-  vl->next = globals;
-  globals = vl;
+  vl->next = cc->globals;
+  cc->globals = vl;
   return var;
 }
 
 static char *new_label(void) {
-  static int cnt = 0;
-  char buf[20];
-  sprintf(buf, ".L.data.%d", cnt++);
-  return strndup(buf, 20);
+  char *buf = arena_alloc(&cc->arena, 20);
+  snprintf(buf, 20, ".L.data.%d", cc->data_labels++);
+  return buf;
 }
 
-static Function *function(void);
+static Function *function(Type *ty, char *name);
 static Type *basetype(void);
 static Type *struct_decl(void);
 static Member *struct_member(void);
-static void global_var(void);
+static void global_var(Type *ty, char *name);
 static Node *declaration(void);
 static bool is_typename(void);
 static Node *stmt(void);
@@ -140,36 +190,26 @@ static Node *unary(void);
 static Node *postfix(void);
 static Node *primary(void);
 
-static bool is_function(void) {
-  Token *tok = token;
-  basetype();
-  bool isfunc = consume_ident() && consume("(");
-  token = tok;
-  return isfunc;
-}
-
-Program *program(void) {
-  Function head = {};
-  Function *cur = &head;
-  globals = NULL;
-
+// Parses top-level declarations up to and including the next function
+// definition, and returns that function. Global variables are collected
+// along the way. Returns NULL at the end of input.
+Function *next_function(void) {
   while (!at_eof()) {
-    if (is_function()) {
-      cur->next = function();
-      cur = cur->next;
-    } else {
-      global_var();
-    }
+    // Both functions and global variables start with a type and a
+    // name; what follows tells them apart.
+    Type *ty = basetype();
+    char *name = expect_ident();
+
+    if (consume("("))
+      return function(ty, name);
+    global_var(ty, name);
   }
-  Program *prog = calloc(1, sizeof(Program));
-  prog->globals = globals;
-  prog->fns = head.next;
-  return prog;
+  return NULL;
 }
 
 static Type *basetype(void) {
   if (!is_typename())
-    error_tok(token, "typename expected");
+    error_tok(cc->token, "typename expected");
 
   Type *ty;
   if (consume("char"))
@@ -193,24 +233,16 @@ static Type *read_type_suffix(Type *base) {
   return array_of(base, sz);
 }
 
-static void push_tag_scope(Token *tok, Type *ty) {
-  TagScope *sc = calloc(1, sizeof(TagScope));
-  sc->next = tag_scope;
-  sc->name = strndup(tok->str, tok->len);
-  sc->ty = ty;
-  tag_scope = sc;
-}
-
 static Type *struct_decl(void) {
   expect("struct");
 
   // Read a struct tag.
   Token *tag = consume_ident();
   if (tag && !peek("{")) {
-    TagScope *sc = find_tag(tag);
-    if (!sc)
+    Type *ty = find_tag(tag);
+    if (!ty)
       error_tok(tag, "Unknown struct type");
-    return sc->ty;
+    return ty;
   }
 
   expect("{");
@@ -224,7 +256,7 @@ static Type *struct_decl(void) {
     cur = cur->next;
   }
 
-  Type *ty = calloc(1, sizeof(Type));
+  Type *ty = arena_alloc(&cc->arena, sizeof(Type));
   ty->kind = TY_STRUCT;
   ty->members = head.next;
 
@@ -241,12 +273,12 @@ static Type *struct_decl(void) {
   ty->size = align_to(offset, ty->align);
 
   if (tag)
-    push_tag_scope(tag, ty);
+    scope_put(&cc->tag_scope, tag->name, ty);
   return ty;
 }
 
 static Member *struct_member(void) {
-  Member *mem = calloc(1, sizeof(Member));
+  Member *mem = arena_alloc(&cc->arena, sizeof(Member));
   mem->ty = basetype();
   mem->name = expect_ident();
   mem->ty = read_type_suffix(mem->ty);
@@ -259,7 +291,7 @@ static VarList *read_func_param(void) {
   char *name = expect_ident();
   ty = read_type_suffix(ty);
 
-  VarList *vl = calloc(1, sizeof(VarList));
+  VarList *vl = arena_alloc(cc->fn_arena, sizeof(VarList));
   vl->var = new_lvar(name, ty);
   return vl;
 }
@@ -270,24 +302,28 @@ static VarList *read_func_params(void) {
 
   VarList *head = read_func_param();
   VarList *cur = head;
+  int n = 1;
 
   while (!consume(")")) {
+    Token *tok = cc->token;
     expect(",");
+    if (++n > MAX_ARGS)
+      error_tok(tok, "too many parameters");
     cur->next = read_func_param();
     cur = cur->next;
   }
   return head;
 }
 
-static Function *function(void) {
-  locals = NULL;
+// Parses the rest of a function definition after its opening "(".
+static Function *function(Type *ty, char *name) {
+  cc->locals = NULL;
 
-  Function *fn = calloc(1, sizeof(Function));
-  basetype();
-  fn->name = expect_ident();
-  expect("(");
+  Function *fn = arena_alloc(&cc->arena, sizeof(Function));
+  cc->fn_arena = &fn->arena;
+  fn->name = name;
 
-  Scope *sc = enter_scope();
+  Scope sc = enter_scope();
   fn->params = read_func_params();
   expect("{");
 
@@ -301,20 +337,20 @@ static Function *function(void) {
   leave_scope(sc);
 
   fn->node = head.next;
-  fn->locals = locals;
+  fn->locals = cc->locals;
+  cc->fn_arena = &cc->arena;
   return fn;
 }
 
-static void global_var(void) {
-  Type *ty = basetype();
-  char *name = expect_ident();
+// Parses the rest of a global variable declaration after its name.
+static void global_var(Type *ty, char *name) {
   ty = read_type_suffix(ty);
   expect(";");
   new_gvar(name, ty);
 }
 
 static Node *declaration(void) {
-  Token *tok = token;
+  Token *tok = cc->token;
   Type *ty = basetype();
   if (consume(";"))
     return new_node(ND_NULL, tok);
@@ -335,7 +371,7 @@ static Node *declaration(void) {
 }
 
 static Node *read_expr_stmt(void) {
-  Token *tok = token;
+  Token *tok = cc->token;
   return new_unary(ND_EXPR_STMT, expr(), tok);
 }
 
@@ -402,7 +438,7 @@ static Node *stmt2(void) {
     Node head = {};
     Node *cur = &head;
 
-    Scope *sc = enter_scope();
+    Scope sc = enter_scope();
     while (!consume("}")) {
       cur->next = stmt();
       cur = cur->next;
@@ -487,7 +523,7 @@ static Node *new_sub(Node *lhs, Node *rhs, Token *tok) {
     return new_binary(ND_SUB, lhs, rhs, tok);
   if (lhs->ty->base && is_integer(rhs->ty))
     return new_binary(ND_PTR_SUB, lhs, rhs, tok);
-  if (lhs->ty->base && rhs->ty->base)
+  if (lhs->ty->base && lhs->ty->base == rhs->ty->base)
     return new_binary(ND_PTR_DIFF, lhs, rhs, tok);
   error_tok(tok, "Invalid operands");
 }
@@ -536,7 +572,7 @@ static Node *unary(void) {
 
 static Member *find_member(Type *ty, char *name) {
   for (Member *mem = ty->members; mem; mem = mem->next)
-    if (!strcmp(mem->name, name))
+    if (mem->name == name)
       return mem;
   return NULL;
 }
@@ -546,7 +582,7 @@ static Node *struct_ref(Node *lhs) {
   if (lhs->ty->kind != TY_STRUCT)
     error_tok(lhs->tok, "Not a struct");
 
-  Token *tok = token;
+  Token *tok = cc->token;
   Member *mem = find_member(lhs->ty, expect_ident());
   if (!mem)
     error_tok(tok, "No such member");
@@ -577,23 +613,27 @@ static Node *postfix(void) {
 }
 
 static Node *stmt_expr(Token *tok) {
-  Scope *sc = enter_scope();
+  Scope sc = enter_scope();
 
   Node *node = new_node(ND_STMT_EXPR, tok);
-  node->body = stmt();
-  Node *cur = node->body;
+  Node head = {};
+  Node *cur = &head;
+  Node *prev;
 
-  while (!consume("}")) {
-    cur->next = stmt();
-    cur = cur->next;
-  }
+  do {
+    prev = cur;
+    cur = cur->next = stmt();
+  } while (!consume("}"));
 
   expect(")");
   leave_scope(sc);
 
+  // The value of the last expression statement is the value of the
+  // whole statement expression.
   if (cur->kind != ND_EXPR_STMT)
     error_tok(cur->tok, "stmt expr returning void is not supported");
-  memcpy(cur, cur->lhs, sizeof(Node));
+  prev->next = cur->lhs;
+  node->body = head.next;
   return node;
 }
 
@@ -603,7 +643,11 @@ static Node *func_args(void) {
 
   Node *head = assign();
   Node *cur = head;
-  while (consume(",")) {
+  int n = 1;
+  Token *tok;
+  while ((tok = consume(","))) {
+    if (++n > MAX_ARGS)
+      error_tok(tok, "too many arguments");
     cur->next = assign();
     cur = cur->next;
   }
@@ -633,7 +677,7 @@ static Node *primary(void) {
     // Function call
     if (consume("(")) {
       Node *node = new_node(ND_FCALL, tok);
-      node->funcname = strndup(tok->str, tok->len);
+      node->funcname = tok->name;
       node->args = func_args();
       return node;
     }
@@ -645,15 +689,21 @@ static Node *primary(void) {
     return new_var_node(var, tok);
   }
 
-  tok = token;
+  tok = cc->token;
 
   if (tok->kind == TK_STR) {
-    token = token->next;
-
-    Type *ty = array_of(char_type, tok->cont_len);
-    Var *var = new_gvar(new_label(), ty);
-    var->contents = tok->contents;
-    var->cont_len = tok->cont_len;
+    cc->token++;
+
+    // Identical literals share one object. Their contents are interned
+    // so that they can be looked up by pointer.
+    char *contents = intern(tok->contents, tok->cont_len);
+    Var *var = scope_get(&cc->literals, contents);
+    if (!var) {
+      var = new_gvar(new_label(), array_of(char_type, tok->cont_len));
+      var->contents = contents;
+      var->cont_len = tok->cont_len;
+      scope_put(&cc->literals, contents, var);
+    }
     return new_var_node(var, tok);
   }
 
@@ -0,0 +1,290 @@
+#include "9cc.h"
+
+// Peephole optimizer over the instructions selected for a function by
+// codegen.c. It fuses compares with the conditional jumps that test
+// their result, folds constants and frame addresses into the
+// instructions that use them, drops jumps to the next instruction, and
+// drops the frame of functions that have no use for one.
+//
+// Most rewrites do away with a register, which is only valid if nothing
+// reads it later, so they consult a liveness analysis over the list.
+// Rewrites only ever remove reads of registers, so the live sets stay
+// correct, if conservative, while a pass changes the list.
+
+typedef uint32_t RegSet;
+
+#define BIT(r) ((RegSet)1 << (r))
+
+static RegSet arg_regs =
+  BIT(RDI) | BIT(RSI) | BIT(RDX) | BIT(RCX) | BIT(R8) | BIT(R9);
+static RegSet caller_saved =
+  BIT(RAX) | BIT(RCX) | BIT(RDX) | BIT(RSI) | BIT(RDI) | BIT(R8) | BIT(R9) |
+  BIT(R10) | BIT(R11);
+static RegSet callee_saved =
+  BIT(RBX) | BIT(RSP) | BIT(RBP) | BIT(R12) | BIT(R13) | BIT(R14) | BIT(R15);
+
+static RegSet reg_of(Operand *op) {
+  if (op->kind == OPD_REG || op->kind == OPD_MEM)
+    return BIT(op->reg);
+  return 0;
+}
+
+static bool is_reg(Operand *op, Reg r) {
+  return op->kind == OPD_REG && op->reg == r;
+}
+
+static bool is_jump(InsKind kind) {
+  return kind == I_JMP || (I_JE <= kind && kind <= I_JGE);
+}
+
+// Registers that `i` reads and writes. A SETcc writes only the low
+// byte of its register, but codegen.c always zero-extends it right
+// after, so it is treated as writing the whole register.
+static void reads_writes(Ins *i, RegSet *use, RegSet *def) {
+  *use = *def = 0;
+  switch (i->kind) {
+  case I_PUSH:
+    *use = reg_of(&i->a) | BIT(RSP);
+    *def = BIT(RSP);
+    return;
+  case I_POP:
+    *use = BIT(RSP);
+    *def = reg_of(&i->a) | BIT(RSP);
+    return;
+  case I_MOV:
+  case I_MOVSX:
+  case I_MOVZX:
+  case I_LEA:
+    *use = reg_of(&i->b);
+    if (i->a.kind == OPD_REG)
+      *def = BIT(i->a.reg);
+    else
+      *use |= reg_of(&i->a);
+    return;
+  case I_ADD:
+  case I_SUB:
+  case I_IMUL:
+  case I_AND:
+    *use = reg_of(&i->a) | reg_of(&i->b);
+    *def = reg_of(&i->a);
+    return;
+  case I_CMP:
+    *use = reg_of(&i->a) | reg_of(&i->b);
+    return;
+  case I_CQO:
+    *use = BIT(RAX);
+    *def = BIT(RDX);
+    return;
+  case I_IDIV:
+    *use = BIT(RAX) | BIT(RDX) | reg_of(&i->a);
+    *def = BIT(RAX) | BIT(RDX);
+    return;
+  case I_SETE:
+  case I_SETNE:
+  case I_SETL:
+  case I_SETLE:
+  case I_SETG:
+  case I_SETGE:
+    *def = BIT(i->a.reg);
+    return;
+  case I_CALL:
+    // rax holds the number of vector arguments of a variadic call.
+    *use = arg_regs | BIT(RAX) | BIT(RSP);
+    *def = caller_saved;
+    return;
+  case I_RET:
+    *use = BIT(RAX) | callee_saved;
+    return;
+  default:
+    return;
+  }
+}
+
+// Computes the registers live after each instruction into live[].
+static void liveness(InsList *list, RegSet *live) {
+  Ins *ins = list->data;
+  int n = list->len;
+
+  int labels = 0;
+  for (int i = 0; i < n; i++)
+    if (ins[i].kind == I_LABEL && labels <= ins[i].a.val)
+      labels = ins[i].a.val + 1;
+  int *label_pos = calloc(labels, sizeof(int));
+  for (int i = 0; i < n; i++)
+    if (ins[i].kind == I_LABEL)
+      label_pos[ins[i].a.val] = i;
+
+  RegSet *use = malloc(sizeof(RegSet) * n);
+  RegSet *def = malloc(sizeof(RegSet) * n);
+  RegSet *live_in = calloc(n + 1, sizeof(RegSet));
+  for (int i = 0; i < n; i++)
+    reads_writes(&ins[i], &use[i], &def[i]);
+
+  // Iterate to a fixed point, backwards since liveness flows from uses
+  // back to definitions. Only loops take more than one round.
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int i = n - 1; i >= 0; i--) {
+      RegSet out = 0;
+      if (ins[i].kind != I_JMP && ins[i].kind != I_RET)
+        out = live_in[i + 1];
+      if (is_jump(ins[i].kind))
+        out |= live_in[label_pos[ins[i].a.val]];
+
+      RegSet in = use[i] | (out & ~def[i]);
+      if (in != live_in[i])
+        changed = true;
+      live_in[i] = in;
+      live[i] = out;
+    }
+  }
+
+  free(label_pos);
+  free(use);
+  free(def);
+  free(live_in);
+}
+
+// Removes the instructions marked in `gone`.
+static void compact(InsList *list, bool *gone) {
+  int n = 0;
+  for (int i = 0; i < list->len; i++)
+    if (!gone[i])
+      list->data[n++] = list->data[i];
+  list->len = n;
+}
+
+// The conditional jump taken if the condition of a SETcc holds, and
+// the one taken if it does not
+static InsKind jump_if[] = {
+  [I_SETE] = I_JE, [I_SETNE] = I_JNE, [I_SETL] = I_JL,
+  [I_SETLE] = I_JLE, [I_SETG] = I_JG, [I_SETGE] = I_JGE,
+};
+
+static InsKind jump_unless[] = {
+  [I_SETE] = I_JNE, [I_SETNE] = I_JE, [I_SETL] = I_JGE,
+  [I_SETLE] = I_JG, [I_SETG] = I_JLE, [I_SETGE] = I_JL,
+};
+
+// "setCC r8; movzx r, r8; cmp r, 0; je/jne L" after a compare becomes
+// "jCC L", or the inverse, if nothing reads r afterwards. Returns the
+// number of instructions removed.
+static int fuse_branch(Ins *i, RegSet *live) {
+  if (i[0].kind < I_SETE || I_SETGE < i[0].kind)
+    return 0;
+
+  Reg r = i[0].a.reg;
+  if (i[1].kind != I_MOVZX || !is_reg(&i[1].a, r) || !is_reg(&i[1].b, r) ||
+      i[2].kind != I_CMP || !is_reg(&i[2].a, r) || i[2].b.kind != OPD_IMM ||
+      i[2].b.val != 0 || (i[3].kind != I_JE && i[3].kind != I_JNE) ||
+      live[3] & BIT(r))
+    return 0;
+
+  i[3].kind = i[3].kind == I_JNE ? jump_if[i[0].kind] : jump_unless[i[0].kind];
+  return 3;
+}
+
+// "mov r, imm; op a, r" becomes "op a, imm" if nothing reads r
+// afterwards.
+static bool fold_imm(Ins *i, RegSet *live) {
+  if (i[0].kind != I_MOV || i[0].a.kind != OPD_REG || i[0].b.kind != OPD_IMM)
+    return false;
+
+  Reg r = i[0].a.reg;
+  InsKind k = i[1].kind;
+  if (k != I_MOV && k != I_ADD && k != I_SUB && k != I_IMUL && k != I_AND &&
+      k != I_CMP)
+    return false;
+  if (i[1].a.kind != OPD_REG || i[1].a.reg == r || !is_reg(&i[1].b, r) ||
+      live[1] & BIT(r))
+    return false;
+
+  i[1].b = i[0].b;
+  return true;
+}
+
+// "lea r, [rbp+d]" followed by a load or store through r becomes a load
+// or store at [rbp+d] if nothing reads r afterwards, or the load
+// overwrites it.
+static bool fold_lea(Ins *i, RegSet *live) {
+  if (i[0].kind != I_LEA || i[0].b.reg != RBP)
+    return false;
+
+  Reg r = i[0].a.reg;
+  Operand *m;
+  if ((i[1].kind == I_MOV || i[1].kind == I_MOVSX) && i[1].b.kind == OPD_MEM &&
+      i[1].b.reg == r && (is_reg(&i[1].a, r) || !(live[1] & BIT(r))))
+    m = &i[1].b;
+  else if (i[1].kind == I_MOV && i[1].a.kind == OPD_MEM && i[1].a.reg == r &&
+           !is_reg(&i[1].b, r) && !(live[1] & BIT(r)))
+    m = &i[1].a;
+  else
+    return false;
+
+  m->reg = RBP;
+  m->val += i[0].b.val;
+  return true;
+}
+
+// Whether the target of a jump is next, with only labels in between
+static bool jumps_to_next(Ins *jump, Ins *end) {
+  for (Ins *i = jump + 1; i < end && i->kind == I_LABEL; i++)
+    if (i->a.val == jump->a.val)
+      return true;
+  return false;
+}
+
+// A function that makes no calls and uses neither rbp nor rsp in its
+// body does not need its frame: drop "push rbp; mov rbp, rsp" and
+// "mov rsp, rbp; pop rbp" around the body.
+static void drop_frame(InsList *list) {
+  Ins *ins = list->data;
+  int n = list->len;
+  if (n < 5 || ins[0].kind != I_PUSH || !is_reg(&ins[0].a, RBP) ||
+      ins[1].kind != I_MOV || !is_reg(&ins[1].a, RBP) ||
+      ins[n - 3].kind != I_MOV || !is_reg(&ins[n - 3].a, RSP) ||
+      ins[n - 2].kind != I_POP)
+    return;
+
+  for (int i = 2; i < n - 3; i++) {
+    RegSet use, def;
+    reads_writes(&ins[i], &use, &def);
+    if (ins[i].kind == I_CALL || (use | def) & (BIT(RSP) | BIT(RBP)))
+      return;
+  }
+
+  memmove(ins, ins + 2, sizeof(Ins) * (n - 5));
+  ins[n - 5] = ins[n - 1];
+  list->len = n - 4;
+}
+
+// Rewrites the instructions of a function in place.
+void peephole(InsList *list) {
+  RegSet *live = malloc(sizeof(RegSet) * list->len);
+  bool *gone = calloc(list->len, sizeof(bool));
+
+  // Fuse branches first, which leaves their compares for fold_imm().
+  liveness(list, live);
+  for (int i = 0; i + 3 < list->len; i++) {
+    int k = fuse_branch(list->data + i, live + i);
+    for (int j = 0; j < k; j++)
+      gone[i + j] = true;
+  }
+  compact(list, gone);
+
+  liveness(list, live);
+  memset(gone, 0, list->len);
+  Ins *ins = list->data;
+  int n = list->len;
+  for (int i = 0; i < n; i++) {
+    if (is_jump(ins[i].kind) && jumps_to_next(ins + i, ins + n))
+      gone[i] = true;
+    else if (i + 1 < n && (fold_imm(ins + i, live + i) || fold_lea(ins + i, live + i)))
+      gone[i] = true;
+  }
+  compact(list, gone);
+
+  drop_frame(list);
+  free(live);
+  free(gone);
+}
@@ -0,0 +1,318 @@
+#include "9cc.h"
+
+// Linear-scan register allocation. Each virtual register gets a single
+// live interval over the instructions in layout order, from its first
+// definition to its last use, widened to cover every block it is live
+// through. Intervals are then assigned to physical registers in order
+// of their start, spilling the one that ends last when too many overlap.
+//
+// Instruction k reads its operands at position 2k and writes its result
+// at 2k+1, so a result may take the register of an operand that dies in
+// the same instruction.
+//
+// A call clobbers the caller-saved registers, so an interval that is
+// live across one can only have a callee-saved register. rax, rdx and
+// r11 are never allocated: codegen.c needs them as scratch registers.
+
+static Reg caller_saved[] = {RCX, RSI, RDI, R8, R9, R10};
+static Reg callee_saved[] = {RBX, R12, R13, R14, R15};
+
+#define NUM_CALLER_SAVED (sizeof(caller_saved) / sizeof(*caller_saved))
+#define NUM_CALLEE_SAVED (sizeof(callee_saved) / sizeof(*callee_saved))
+#define MAX_ACTIVE (NUM_CALLER_SAVED + NUM_CALLEE_SAVED)
+
+typedef struct {
+  int reg; // virtual register
+  int start;
+  int end;
+  bool across_call;
+} Interval;
+
+static int uses(IrIns *i, int *buf) {
+  if (i->op == IR_CALL) {
+    memcpy(buf, i->args, sizeof(int) * i->nargs);
+    return i->nargs;
+  }
+  int n = 0;
+  if (i->a)
+    buf[n++] = i->a;
+  if (i->b)
+    buf[n++] = i->b;
+  return n;
+}
+
+static int num_succs(IrIns *last, BasicBlock **succ) {
+  if (last->op == IR_JMP) {
+    succ[0] = last->then;
+    return 1;
+  }
+  if (last->op == IR_BR) {
+    succ[0] = last->then;
+    succ[1] = last->els;
+    return 2;
+  }
+  return 0;
+}
+
+// Bit sets of live registers, one word array per block
+typedef uint64_t Word;
+
+static bool set_has(Word *set, int i) {
+  return set[i / 64] >> (i % 64) & 1;
+}
+
+static void set_add(Word *set, int i) {
+  set[i / 64] |= (Word)1 << (i % 64);
+}
+
+// Computes which virtual registers are live into and out of each block.
+// Only registers that are used in a block other than the one defining
+// them are tracked; the rest never outlive their block. Returns the
+// number of tracked registers, with global[v] set to the index of v
+// among them, or -1.
+static int liveness(IrFunction *fn, BasicBlock **blocks, int *global,
+                    Word **live_in, Word **live_out) {
+  Arena *arena = fn->arena;
+  int *def_block = arena_alloc(arena, sizeof(int) * (fn->nregs + 1));
+  int nglobals = 0;
+  int buf[MAX_ARGS];
+
+  for (int v = 0; v <= fn->nregs; v++)
+    global[v] = -1;
+
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+    for (IrIns *i = bb->ins; i; i = i->next) {
+      int n = uses(i, buf);
+      for (int j = 0; j < n; j++)
+        if (def_block[buf[j]] != bb->id && global[buf[j]] < 0)
+          global[buf[j]] = nglobals++;
+      if (i->d)
+        def_block[i->d] = bb->id;
+    }
+  }
+
+  int words = (nglobals + 63) / 64;
+  Word *use = arena_alloc(arena, sizeof(Word) * words * (fn->nblocks + 1));
+  Word *def = arena_alloc(arena, sizeof(Word) * words * (fn->nblocks + 1));
+  for (int b = 1; b <= fn->nblocks; b++) {
+    live_in[b] = arena_alloc(arena, sizeof(Word) * words);
+    live_out[b] = arena_alloc(arena, sizeof(Word) * words);
+  }
+  if (!nglobals)
+    return 0;
+
+  // Upward-exposed uses and definitions of each block
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+    Word *u = use + bb->id * words;
+    Word *d = def + bb->id * words;
+    for (IrIns *i = bb->ins; i; i = i->next) {
+      int n = uses(i, buf);
+      for (int j = 0; j < n; j++) {
+        int g = global[buf[j]];
+        if (g >= 0 && !set_has(d, g))
+          set_add(u, g);
+      }
+      if (i->d && global[i->d] >= 0)
+        set_add(d, global[i->d]);
+    }
+  }
+
+  // Iterate to a fixed point, visiting blocks backwards since liveness
+  // flows from uses back to definitions.
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int b = fn->nblocks; b >= 1; b--) {
+      BasicBlock *bb = blocks[b];
+      if (!bb)
+        continue;
+
+      BasicBlock *succ[2];
+      int nsuccs = num_succs(bb->last, succ);
+      Word *in = live_in[b];
+      Word *out = live_out[b];
+      Word *u = use + b * words;
+      Word *d = def + b * words;
+
+      for (int w = 0; w < words; w++) {
+        Word o = 0;
+        for (int s = 0; s < nsuccs; s++)
+          o |= live_in[succ[s]->id][w];
+        Word x = u[w] | (o & ~d[w]);
+        if (o != out[w] || x != in[w])
+          changed = true;
+        out[w] = o;
+        in[w] = x;
+      }
+    }
+  }
+  return nglobals;
+}
+
+static void extend(Interval *iv, int pos) {
+  if (iv->start < 0 || pos < iv->start)
+    iv->start = pos;
+  if (iv->end < pos)
+    iv->end = pos;
+}
+
+static int by_start(const void *a, const void *b) {
+  const Interval *x = a;
+  const Interval *y = b;
+  if (x->start != y->start)
+    return x->start - y->start;
+  return x->reg - y->reg;
+}
+
+// Builds the live interval of each virtual register. Returns them
+// sorted by start in *out, and their number.
+static int build_intervals(IrFunction *fn, Interval **out) {
+  Arena *arena = fn->arena;
+  BasicBlock **blocks = arena_alloc(arena, sizeof(BasicBlock *) * (fn->nblocks + 1));
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next)
+    blocks[bb->id] = bb;
+
+  int *global = arena_alloc(arena, sizeof(int) * (fn->nregs + 1));
+  Word **live_in = arena_alloc(arena, sizeof(Word *) * (fn->nblocks + 1));
+  Word **live_out = arena_alloc(arena, sizeof(Word *) * (fn->nblocks + 1));
+  int nglobals = liveness(fn, blocks, global, live_in, live_out);
+
+  // Tracked registers by index, to walk the live sets
+  int *global_reg = arena_alloc(arena, sizeof(int) * (nglobals + 1));
+  for (int v = 1; v <= fn->nregs; v++)
+    if (global[v] >= 0)
+      global_reg[global[v]] = v;
+
+  Interval *iv = arena_alloc(arena, sizeof(Interval) * (fn->nregs + 1));
+  for (int v = 0; v <= fn->nregs; v++)
+    iv[v] = (Interval){v, -1, -1};
+
+  // Number of calls before each position, to tell which intervals
+  // span a call.
+  int ninsns = 0;
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next)
+    for (IrIns *i = bb->ins; i; i = i->next)
+      ninsns++;
+  int *calls = arena_alloc(arena, sizeof(int) * (ninsns + 1));
+
+  int k = 0;
+  int buf[MAX_ARGS];
+  for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+    int first = k;
+    for (IrIns *i = bb->ins; i; i = i->next, k++) {
+      int n = uses(i, buf);
+      for (int j = 0; j < n; j++)
+        extend(&iv[buf[j]], 2 * k);
+      // codegen.c takes all the arguments out of their registers at
+      // once on entry, so every parameter is defined at the first
+      // instruction, unused ones included.
+      if (i->op == IR_PARAM)
+        extend(&iv[i->d], 1);
+      else if (i->d)
+        extend(&iv[i->d], 2 * k + 1);
+      calls[k + 1] = calls[k] + (i->op == IR_CALL);
+    }
+
+    for (int g = 0; g < nglobals; g++) {
+      if (set_has(live_in[bb->id], g))
+        extend(&iv[global_reg[g]], 2 * first);
+      if (set_has(live_out[bb->id], g))
+        extend(&iv[global_reg[g]], 2 * k - 1);
+    }
+  }
+
+  // An interval is live across the call at instruction k if it covers
+  // both 2k and 2k+1.
+  int n = 0;
+  for (int v = 1; v <= fn->nregs; v++) {
+    if (iv[v].start < 0)
+      continue;
+    int lo = (iv[v].start + 1) / 2;
+    int hi = (iv[v].end - 1) / 2;
+    iv[v].across_call = lo <= hi && calls[hi + 1] > calls[lo];
+    iv[n++] = iv[v];
+  }
+
+  qsort(iv, n, sizeof(Interval), by_start);
+  *out = iv;
+  return n;
+}
+
+static bool is_callee_saved(Reg r) {
+  for (int i = 0; i < NUM_CALLEE_SAVED; i++)
+    if (callee_saved[i] == r)
+      return true;
+  return false;
+}
+
+static void spill(IrFunction *fn, int v) {
+  fn->spill[v] = ++fn->nspills;
+}
+
+// Assigns each virtual register of `fn` a physical register or a spill
+// slot.
+void alloc_regs(IrFunction *fn) {
+  fn->regs = arena_alloc(fn->arena, sizeof(Reg) * (fn->nregs + 1));
+  fn->spill = arena_alloc(fn->arena, sizeof(int) * (fn->nregs + 1));
+  fn->nspills = 0;
+  fn->used_regs = 0;
+
+  Interval *iv;
+  int n = build_intervals(fn, &iv);
+
+  bool free_reg[R15 + 1] = {};
+  for (int i = 0; i < NUM_CALLER_SAVED; i++)
+    free_reg[caller_saved[i]] = true;
+  for (int i = 0; i < NUM_CALLEE_SAVED; i++)
+    free_reg[callee_saved[i]] = true;
+
+  // Intervals that hold a register, unordered
+  Interval *active[MAX_ACTIVE];
+  int nactive = 0;
+
+  for (Interval *cur = iv; cur < iv + n; cur++) {
+    for (int j = 0; j < nactive;) {
+      if (active[j]->end < cur->start) {
+        free_reg[fn->regs[active[j]->reg]] = true;
+        active[j] = active[--nactive];
+      } else {
+        j++;
+      }
+    }
+
+    // Caller-saved registers are free to use, so take one unless the
+    // interval has to survive a call.
+    int r = -1;
+    if (!cur->across_call)
+      for (int i = 0; i < NUM_CALLER_SAVED && r < 0; i++)
+        if (free_reg[caller_saved[i]])
+          r = caller_saved[i];
+    for (int i = 0; i < NUM_CALLEE_SAVED && r < 0; i++)
+      if (free_reg[callee_saved[i]])
+        r = callee_saved[i];
+
+    if (r >= 0) {
+      free_reg[r] = false;
+      fn->regs[cur->reg] = r;
+      fn->used_regs |= 1 << r;
+      active[nactive++] = cur;
+      continue;
+    }
+
+    // Out of registers: spill whichever usable interval ends last.
+    int victim = -1;
+    for (int j = 0; j < nactive; j++) {
+      if (cur->across_call && !is_callee_saved(fn->regs[active[j]->reg]))
+        continue;
+      if (victim < 0 || active[victim]->end < active[j]->end)
+        victim = j;
+    }
+
+    if (victim < 0 || active[victim]->end <= cur->end) {
+      spill(fn, cur->reg);
+      continue;
+    }
+    fn->regs[cur->reg] = fn->regs[active[victim]->reg];
+    spill(fn, active[victim]->reg);
+    active[victim] = cur;
+  }
+}
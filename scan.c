@@ -0,0 +1,222 @@
+#include "9cc.h"
+
+// Scanners for the lexer's inner loops. Each one returns a pointer to
+// the first byte at or after `p` that ends a run, and every run ends at
+// the '\0' that terminates the input at the latest.
+//
+// The vector versions only issue aligned loads. An aligned load never
+// crosses a page boundary, so reading the rest of the block that holds
+// the terminator cannot fault and the input needs no extra padding.
+
+char *(*skip_space)(char *p);
+char *(*skip_ident)(char *p);
+char *(*skip_digits)(char *p);
+char *(*find_line_end)(char *p);
+char *(*find_comment_end)(char *p);
+
+//
+// Scalar fallback
+//
+
+static char *skip_space_scalar(char *p) {
+  while (isspace(*p))
+    p++;
+  return p;
+}
+
+static char *skip_ident_scalar(char *p) {
+  while (is_alnum(*p))
+    p++;
+  return p;
+}
+
+static char *skip_digits_scalar(char *p) {
+  while (isdigit(*p))
+    p++;
+  return p;
+}
+
+static char *find_line_end_scalar(char *p) {
+  while (*p && *p != '\n')
+    p++;
+  return p;
+}
+
+static char *find_comment_end_scalar(char *p) {
+  char *q = strstr(p, "*/");
+  return q ? q : p + strlen(p);
+}
+
+#if defined(__x86_64__) && defined(__SSE2__)
+#include <immintrin.h>
+
+// Each *_stops function below returns a bitmask with bit i set if the
+// i-th byte of the aligned block `a` ends a run. The DEFINE_* macros
+// turn them into scanners for a given vector width.
+
+#define DEFINE_SKIP(name, attr, W, stops)                               \
+  attr static char *name(char *p) {                                     \
+    char *a = (char *)((uintptr_t)p & -(uintptr_t)(W));                 \
+    uint32_t m = stops(a) >> (p - a);                                   \
+    if (m)                                                              \
+      return p + __builtin_ctz(m);                                      \
+    for (;;) {                                                          \
+      a += (W);                                                         \
+      m = stops(a);                                                     \
+      if (m)                                                            \
+        return a + __builtin_ctz(m);                                    \
+    }                                                                   \
+  }
+
+// A "*/" can straddle two blocks. The byte after the block is read only
+// when the block holds no '\0', i.e. when that byte is still input.
+#define DEFINE_COMMENT_END(name, attr, W, stars, slashes, nuls)         \
+  attr static char *name(char *p) {                                     \
+    char *a = (char *)((uintptr_t)p & -(uintptr_t)(W));                 \
+    uint32_t skip = (uint32_t)-1 << (p - a);                            \
+    for (;;) {                                                          \
+      uint32_t star = stars(a);                                         \
+      uint32_t nul = nuls(a);                                           \
+      uint32_t pair = star & (slashes(a) >> 1);                         \
+      if (!nul && (star >> ((W) - 1)) && a[W] == '/')                   \
+        pair |= 1u << ((W) - 1);                                        \
+      uint32_t m = (pair | nul) & skip;                                 \
+      if (m)                                                            \
+        return a + __builtin_ctz(m);                                    \
+      a += (W);                                                         \
+      skip = (uint32_t)-1;                                              \
+    }                                                                   \
+  }
+
+//
+// SSE2, 16 bytes at a time
+//
+
+#define LOAD16(a) _mm_load_si128((__m128i *)(a))
+#define SET16(c) _mm_set1_epi8(c)
+#define IN16(v, lo, hi) \
+  _mm_and_si128(_mm_cmpgt_epi8(v, SET16((lo) - 1)), _mm_cmplt_epi8(v, SET16((hi) + 1)))
+#define BITS16(v) ((uint32_t)_mm_movemask_epi8(v))
+#define NOT16(m) (~(m) & 0xffff)
+
+static inline uint32_t space_stops16(char *a) {
+  __m128i v = LOAD16(a);
+  __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, SET16(' ')), IN16(v, '\t', '\r'));
+  return NOT16(BITS16(ws));
+}
+
+static inline uint32_t ident_stops16(char *a) {
+  __m128i v = LOAD16(a);
+  __m128i lower = _mm_or_si128(v, SET16(0x20));
+  __m128i ok = _mm_or_si128(IN16(lower, 'a', 'z'), IN16(v, '0', '9'));
+  ok = _mm_or_si128(ok, _mm_cmpeq_epi8(v, SET16('_')));
+  return NOT16(BITS16(ok));
+}
+
+static inline uint32_t digit_stops16(char *a) {
+  return NOT16(BITS16(IN16(LOAD16(a), '0', '9')));
+}
+
+static inline uint32_t line_stops16(char *a) {
+  __m128i v = LOAD16(a);
+  return BITS16(_mm_or_si128(_mm_cmpeq_epi8(v, SET16('\n')),
+                             _mm_cmpeq_epi8(v, SET16(0))));
+}
+
+static inline uint32_t stars16(char *a) {
+  return BITS16(_mm_cmpeq_epi8(LOAD16(a), SET16('*')));
+}
+
+static inline uint32_t slashes16(char *a) {
+  return BITS16(_mm_cmpeq_epi8(LOAD16(a), SET16('/')));
+}
+
+static inline uint32_t nuls16(char *a) {
+  return BITS16(_mm_cmpeq_epi8(LOAD16(a), SET16(0)));
+}
+
+DEFINE_SKIP(skip_space_sse2, , 16, space_stops16)
+DEFINE_SKIP(skip_ident_sse2, , 16, ident_stops16)
+DEFINE_SKIP(skip_digits_sse2, , 16, digit_stops16)
+DEFINE_SKIP(find_line_end_sse2, , 16, line_stops16)
+DEFINE_COMMENT_END(find_comment_end_sse2, , 16, stars16, slashes16, nuls16)
+
+//
+// AVX2, 32 bytes at a time, selected at runtime
+//
+
+#define AVX2 __attribute__((target("avx2")))
+#define LOAD32(a) _mm256_load_si256((__m256i *)(a))
+#define SET32(c) _mm256_set1_epi8(c)
+#define IN32(v, lo, hi) \
+  _mm256_and_si256(_mm256_cmpgt_epi8(v, SET32((lo) - 1)), _mm256_cmpgt_epi8(SET32((hi) + 1), v))
+#define BITS32(v) ((uint32_t)_mm256_movemask_epi8(v))
+
+AVX2 static inline uint32_t space_stops32(char *a) {
+  __m256i v = LOAD32(a);
+  __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, SET32(' ')), IN32(v, '\t', '\r'));
+  return ~BITS32(ws);
+}
+
+AVX2 static inline uint32_t ident_stops32(char *a) {
+  __m256i v = LOAD32(a);
+  __m256i lower = _mm256_or_si256(v, SET32(0x20));
+  __m256i ok = _mm256_or_si256(IN32(lower, 'a', 'z'), IN32(v, '0', '9'));
+  ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(v, SET32('_')));
+  return ~BITS32(ok);
+}
+
+AVX2 static inline uint32_t digit_stops32(char *a) {
+  return ~BITS32(IN32(LOAD32(a), '0', '9'));
+}
+
+AVX2 static inline uint32_t line_stops32(char *a) {
+  __m256i v = LOAD32(a);
+  return BITS32(_mm256_or_si256(_mm256_cmpeq_epi8(v, SET32('\n')),
+                                _mm256_cmpeq_epi8(v, SET32(0))));
+}
+
+AVX2 static inline uint32_t stars32(char *a) {
+  return BITS32(_mm256_cmpeq_epi8(LOAD32(a), SET32('*')));
+}
+
+AVX2 static inline uint32_t slashes32(char *a) {
+  return BITS32(_mm256_cmpeq_epi8(LOAD32(a), SET32('/')));
+}
+
+AVX2 static inline uint32_t nuls32(char *a) {
+  return BITS32(_mm256_cmpeq_epi8(LOAD32(a), SET32(0)));
+}
+
+DEFINE_SKIP(skip_space_avx2, AVX2, 32, space_stops32)
+DEFINE_SKIP(skip_ident_avx2, AVX2, 32, ident_stops32)
+DEFINE_SKIP(skip_digits_avx2, AVX2, 32, digit_stops32)
+DEFINE_SKIP(find_line_end_avx2, AVX2, 32, line_stops32)
+DEFINE_COMMENT_END(find_comment_end_avx2, AVX2, 32, stars32, slashes32, nuls32)
+#endif
+
+// Picks the widest scanners the CPU supports.
+void scan_init(void) {
+  skip_space = skip_space_scalar;
+  skip_ident = skip_ident_scalar;
+  skip_digits = skip_digits_scalar;
+  find_line_end = find_line_end_scalar;
+  find_comment_end = find_comment_end_scalar;
+
+#if defined(__x86_64__) && defined(__SSE2__)
+  skip_space = skip_space_sse2;
+  skip_ident = skip_ident_sse2;
+  skip_digits = skip_digits_sse2;
+  find_line_end = find_line_end_sse2;
+  find_comment_end = find_comment_end_sse2;
+
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    skip_space = skip_space_avx2;
+    skip_ident = skip_ident_avx2;
+    skip_digits = skip_digits_avx2;
+    find_line_end = find_line_end_avx2;
+    find_comment_end = find_comment_end_avx2;
+  }
+#endif
+}
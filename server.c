@@ -0,0 +1,317 @@
+#include "9cc.h"
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Compile server. `9cc --serve SOCKET` keeps a warm process listening
+// on a Unix domain socket and compiles each request on its own thread.
+// `9cc --client SOCKET` is a drop-in replacement for the compiler that
+// forwards its work to the server.
+//
+// Each connection carries one request and one response. Both are a
+// sequence of fields, each written as its length in decimal, a
+// newline and then that many bytes.
+//
+//   request:  op, name, source, output path
+//   response: status, diagnostics, assembly
+//
+// op is "file" to compile the file `name`, "source" to compile the
+// inline `source` under the name `name`, or "stats" to read the
+// server's counters. If the output path is empty, the assembly is sent
+// back in the response; otherwise the server writes it to that path.
+
+// Latency counters, in seconds
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static long stats_requests;
+static long stats_failures;
+static double stats_total;
+static double stats_max;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool write_all(int fd, char *buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, buf, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool read_all(int fd, char *buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = read(fd, buf, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool send_field(int fd, char *buf, size_t len) {
+  char hdr[32];
+  int n = snprintf(hdr, sizeof(hdr), "%zu\n", len);
+  return write_all(fd, hdr, n) && write_all(fd, buf, len);
+}
+
+static bool send_str(int fd, char *s) {
+  return send_field(fd, s, strlen(s));
+}
+
+static bool send_response(int fd, char *status, char *diags, size_t diags_len,
+                          char *asm_buf, size_t asm_len) {
+  return send_str(fd, status) && send_field(fd, diags, diags_len) &&
+         send_field(fd, asm_buf, asm_len);
+}
+
+// Reads a field into a NUL-terminated heap buffer. Returns NULL on a
+// malformed or truncated field.
+static char *recv_field(int fd, size_t *len) {
+  size_t n = 0;
+  for (int i = 0;; i++) {
+    char c;
+    if (i == 20 || !read_all(fd, &c, 1))
+      return NULL;
+    if (c == '\n')
+      break;
+    if (!isdigit(c))
+      return NULL;
+    n = n * 10 + c - '0';
+  }
+
+  char *buf = malloc(n + 1);
+  if (!buf || !read_all(fd, buf, n)) {
+    free(buf);
+    return NULL;
+  }
+  buf[n] = '\0';
+  if (len)
+    *len = n;
+  return buf;
+}
+
+static int connect_to(char *path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(addr.sun_path))
+    error("%s: socket path too long", path);
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    error("cannot connect to %s: %s", path, strerror(errno));
+  return fd;
+}
+
+//
+// Server
+//
+
+static char *stats_text(void) {
+  pthread_mutex_lock(&stats_lock);
+  char *buf;
+  asprintf(&buf,
+           "requests: %ld\nfailures: %ld\n"
+           "latency: mean %.3f ms, max %.3f ms\n",
+           stats_requests, stats_failures,
+           stats_requests ? stats_total / stats_requests * 1000 : 0,
+           stats_max * 1000);
+  pthread_mutex_unlock(&stats_lock);
+  return buf;
+}
+
+// Compiles one request. The assembly goes to `out_path`, or into
+// *asm_buf if `out_path` is empty. Diagnostics are returned in *diags.
+static int serve_compile(char *op, char *name, char *src, size_t src_len,
+                         char *out_path, char **asm_buf, size_t *asm_len,
+                         char **diags, size_t *diags_len) {
+  FILE *diag_out = open_memstream(diags, diags_len);
+  FILE *out = *out_path ? fopen(out_path, "w") : open_memstream(asm_buf, asm_len);
+  if (!out) {
+    fprintf(diag_out, "cannot open %s: %s\n", out_path, strerror(errno));
+    fclose(diag_out);
+    return -1;
+  }
+
+  Compiler *c = new_compiler(name, file_sink(out));
+  int status;
+  if (!strcmp(op, "file")) {
+    status = compile_file(c);
+  } else if (!strcmp(op, "source")) {
+    status = compile_buffer(c, src, src_len);
+  } else {
+    fprintf(diag_out, "unknown request: %s\n", op);
+    status = -1;
+  }
+
+  for (Diag *diag = c->diags; diag; diag = diag->next)
+    fprintf(diag_out, "%s\n", diag->msg);
+  free_compiler(c);
+
+  if (fclose(out) && *out_path) {
+    fprintf(diag_out, "cannot write %s: %s\n", out_path, strerror(errno));
+    status = -1;
+  }
+  if (status && *out_path)
+    unlink(out_path);
+  fclose(diag_out);
+  return status;
+}
+
+static void *serve_conn(void *arg) {
+  int fd = (intptr_t)arg;
+  double start = now();
+
+  size_t src_len;
+  char *op = recv_field(fd, NULL);
+  char *name = op ? recv_field(fd, NULL) : NULL;
+  char *src = name ? recv_field(fd, &src_len) : NULL;
+  char *out_path = src ? recv_field(fd, NULL) : NULL;
+
+  if (out_path && !strcmp(op, "stats")) {
+    char *text = stats_text();
+    send_response(fd, "0", text, strlen(text), "", 0);
+    free(text);
+  } else if (out_path) {
+    char *asm_buf = NULL, *diags = NULL;
+    size_t asm_len = 0, diags_len = 0;
+    int status = serve_compile(op, name, src, src_len, out_path,
+                               &asm_buf, &asm_len, &diags, &diags_len);
+
+    send_response(fd, status ? "1" : "0", diags, diags_len,
+                  asm_buf ? asm_buf : "", asm_len);
+    free(asm_buf);
+    free(diags);
+
+    double elapsed = now() - start;
+    pthread_mutex_lock(&stats_lock);
+    stats_requests++;
+    stats_failures += status != 0;
+    stats_total += elapsed;
+    if (stats_max < elapsed)
+      stats_max = elapsed;
+    pthread_mutex_unlock(&stats_lock);
+  }
+
+  free(op);
+  free(name);
+  free(src);
+  free(out_path);
+  close(fd);
+  return NULL;
+}
+
+// Serves compile requests on the Unix socket at `path` until killed.
+int serve(char *path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(addr.sun_path))
+    error("%s: socket path too long", path);
+  strcpy(addr.sun_path, path);
+
+  // A client going away must not kill the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0)
+    error("cannot create socket: %s", strerror(errno));
+  unlink(path);
+  if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(sock, 128) < 0)
+    error("cannot listen on %s: %s", path, strerror(errno));
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  for (;;) {
+    int fd = accept(sock, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      error("accept: %s", strerror(errno));
+    }
+
+    pthread_t thr;
+    if (pthread_create(&thr, &attr, serve_conn, (void *)(intptr_t)fd)) {
+      fprintf(stderr, "cannot create thread: %s\n", strerror(errno));
+      close(fd);
+    }
+  }
+}
+
+//
+// Client
+//
+
+// Returns `path` made absolute against the client's working directory,
+// since the server's may differ.
+static char *absolute_path(char *path) {
+  if (path[0] == '/')
+    return path;
+
+  char *cwd = getcwd(NULL, 0);
+  if (!cwd)
+    error("getcwd: %s", strerror(errno));
+  char *buf;
+  if (asprintf(&buf, "%s/%s", cwd, path) < 0)
+    error("out of memory");
+  free(cwd);
+  return buf;
+}
+
+// Reads all of stdin into a heap buffer.
+static char *read_stdin(size_t *len) {
+  char *buf;
+  FILE *out = open_memstream(&buf, len);
+  char chunk[65536];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
+    fwrite(chunk, 1, n, out);
+  fclose(out);
+  return buf;
+}
+
+// Sends one request for `path` to the server at `sock_path`. With
+// `path` NULL, asks for the server's counters instead. Behaves like the
+// compiler itself: assembly to `out_path` or stdout, diagnostics to
+// stderr, and the exit status of the compilation.
+int client(char *sock_path, char *path, char *out_path) {
+  int fd = connect_to(sock_path);
+  out_path = out_path ? absolute_path(out_path) : "";
+
+  bool ok;
+  if (!path) {
+    ok = send_str(fd, "stats") && send_str(fd, "") && send_str(fd, "") &&
+         send_str(fd, "");
+  } else if (!strcmp(path, "-")) {
+    size_t len;
+    char *src = read_stdin(&len);
+    ok = send_str(fd, "source") && send_str(fd, "-") &&
+         send_field(fd, src, len) && send_str(fd, out_path);
+    free(src);
+  } else {
+    ok = send_str(fd, "file") && send_str(fd, absolute_path(path)) &&
+         send_str(fd, "") && send_str(fd, out_path);
+  }
+
+  size_t diags_len, asm_len;
+  char *status = ok ? recv_field(fd, NULL) : NULL;
+  char *diags = status ? recv_field(fd, &diags_len) : NULL;
+  char *asm_buf = diags ? recv_field(fd, &asm_len) : NULL;
+  if (!asm_buf)
+    error("%s: no response from server", sock_path);
+  close(fd);
+
+  fwrite(diags, 1, diags_len, path ? stderr : stdout);
+  fwrite(asm_buf, 1, asm_len, stdout);
+  return strcmp(status, "0") ? 1 : 0;
+}
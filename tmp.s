@@ -0,0 +1,2746 @@
+.intel_syntax noprefix
+.text
+.global assert
+assert:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-32], rbx
+  mov [rbp-40], r12
+  mov [rbp-48], r13
+.L.assert.1:
+  mov rbx, rdi
+  mov r12, rsi
+  mov r13, rdx
+  cmp rbx, r12
+  jne .L.assert.3
+.L.assert.2:
+  mov rcx, offset .L.data.0
+  mov rdi, rcx
+  mov rsi, r13
+  mov rdx, r12
+  mov rax, 0
+  call printf
+  mov rcx, rax
+  jmp .L.assert.4
+.L.assert.3:
+  mov rcx, offset .L.data.1
+  mov rdi, rcx
+  mov rsi, r13
+  mov rdx, rbx
+  mov rcx, r12
+  mov rax, 0
+  call printf
+  mov rcx, rax
+  mov rcx, 1
+  mov rdi, rcx
+  mov rax, 0
+  call exit
+  mov rcx, rax
+.L.assert.4:
+.L.return.assert:
+  mov rbx, [rbp-32]
+  mov r12, [rbp-40]
+  mov r13, [rbp-48]
+  mov rsp, rbp
+  pop rbp
+  ret
+.global ret3
+ret3:
+.L.ret3.1:
+  mov rax, 3
+  jmp .L.return.ret3
+.L.ret3.2:
+  mov rax, 5
+.L.ret3.3:
+.L.return.ret3:
+  ret
+.global add2
+add2:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.add2.1:
+  mov rcx, rdi
+  add rcx, rsi
+  mov rax, rcx
+.L.add2.2:
+.L.return.add2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global sub2
+sub2:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.sub2.1:
+  mov rcx, rdi
+  sub rcx, rsi
+  mov rax, rcx
+.L.sub2.2:
+.L.return.sub2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global add6
+add6:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+.L.add6.1:
+  mov r10, r9
+  mov r9, r8
+  mov r8, rcx
+  mov rcx, rdi
+  mov rdi, rdx
+  add rcx, rsi
+  add rcx, rdi
+  add rcx, r8
+  add rcx, r9
+  add rcx, r10
+  mov rax, rcx
+.L.add6.2:
+.L.return.add6:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global last_of4
+last_of4:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+.L.last_of4.1:
+  mov r8, rcx
+  mov rcx, rdi
+  mov rdi, rdx
+  mov rax, r8
+.L.last_of4.2:
+.L.return.last_of4:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global addx
+addx:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.addx.1:
+  mov rcx, rdi
+  mov rcx, [rcx]
+  add rcx, rsi
+  mov rax, rcx
+.L.addx.2:
+.L.return.addx:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global sub_char
+sub_char:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.sub_char.1:
+  mov rcx, rdi
+  mov rdi, rdx
+  movsx rcx, cl
+  movsx rsi, sil
+  movsx rdi, dil
+  sub rcx, rsi
+  sub rcx, rdi
+  mov rax, rcx
+.L.sub_char.2:
+.L.return.sub_char:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global fib
+fib:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+  mov [rbp-16], rbx
+  mov [rbp-24], r12
+.L.fib.1:
+  mov rbx, rdi
+  cmp rbx, 1
+  jg .L.fib.3
+.L.fib.2:
+  mov rax, 1
+  jmp .L.return.fib
+.L.fib.4:
+.L.fib.3:
+  mov r11, 1
+  mov rcx, rbx
+  sub rcx, r11
+  mov rdi, rcx
+  mov rax, 0
+  call fib
+  mov r12, rax
+  mov r11, 2
+  mov rcx, rbx
+  sub rcx, r11
+  mov rdi, rcx
+  mov rax, 0
+  call fib
+  mov rcx, rax
+  add rcx, r12
+  mov rax, rcx
+.L.fib.5:
+.L.return.fib:
+  mov rbx, [rbp-16]
+  mov r12, [rbp-24]
+  mov rsp, rbp
+  pop rbp
+  ret
+.global sum_to
+sum_to:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+.L.sum_to.1:
+  mov rcx, rdi
+  mov rsi, 0
+  mov rdi, 1
+.L.sum_to.2:
+  cmp rdi, rcx
+  jg .L.sum_to.4
+.L.sum_to.3:
+  add rsi, rdi
+  add rdi, 1
+  jmp .L.sum_to.2
+.L.sum_to.4:
+  mov rax, rsi
+.L.sum_to.5:
+.L.return.sum_to:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global compare_all
+compare_all:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+.L.compare_all.1:
+  mov rcx, rdi
+  cmp rcx, rsi
+  setl dil
+  movzx rdi, dil
+  cmp rdi, 0
+  je .L.compare_all.3
+.L.compare_all.2:
+  add rdi, 10
+.L.compare_all.3:
+  cmp rsi, rcx
+  jg .L.compare_all.5
+.L.compare_all.4:
+  add rdi, 100
+.L.compare_all.5:
+  cmp rsi, rcx
+  jge .L.compare_all.7
+.L.compare_all.6:
+  add rdi, 1000
+.L.compare_all.7:
+  cmp rcx, rsi
+  jg .L.compare_all.9
+.L.compare_all.8:
+  add rdi, 10000
+.L.compare_all.9:
+  cmp rcx, rsi
+  jne .L.compare_all.11
+.L.compare_all.10:
+  add rdi, 100000
+.L.compare_all.11:
+  cmp rcx, rsi
+  je .L.compare_all.13
+.L.compare_all.12:
+  add rdi, 1000000
+.L.compare_all.13:
+  mov rax, rdi
+.L.compare_all.14:
+.L.return.compare_all:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global count_to
+count_to:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.count_to.1:
+  mov rcx, rdi
+  mov rsi, 0
+.L.count_to.2:
+.L.count_to.3:
+  cmp rsi, rcx
+  jne .L.count_to.6
+.L.count_to.5:
+  mov rax, rsi
+  jmp .L.return.count_to
+.L.count_to.7:
+.L.count_to.6:
+  add rsi, 1
+  jmp .L.count_to.2
+.L.count_to.4:
+.L.return.count_to:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global leaf_array
+leaf_array:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+.L.leaf_array.1:
+  mov rcx, rdi
+  mov [rbp-16], rcx
+  lea rsi, [rbp-16]
+  add rsi, 8
+  add rcx, 1
+  mov [rsi], rcx
+  mov rcx, [rbp-16]
+  lea rsi, [rbp-16]
+  add rsi, 8
+  mov rsi, [rsi]
+  add rcx, rsi
+  mov rax, rcx
+.L.leaf_array.2:
+.L.return.leaf_array:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global char_wrap
+char_wrap:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.L.char_wrap.1:
+  mov rcx, rdi
+  movsx rcx, cl
+  add rcx, 200
+  movsx rcx, cl
+  mov rax, rcx
+.L.char_wrap.2:
+.L.return.char_wrap:
+  mov rsp, rbp
+  pop rbp
+  ret
+.global main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 2992
+  mov [rbp-2992], rbx
+.L.main.1:
+  mov rcx, 8
+  mov rsi, 3
+  add rsi, 5
+  mov rdi, offset .L.data.2
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.3
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 42
+  mov rsi, 42
+  mov rdi, offset .L.data.4
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  mov rsi, 5
+  mov rdi, offset .L.data.3
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 41
+  mov rsi, 41
+  mov rdi, offset .L.data.5
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  mov rsi, 5
+  mov rdi, offset .L.data.3
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 15
+  mov rsi, 15
+  mov rdi, offset .L.data.6
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  mov rsi, 4
+  mov rdi, offset .L.data.7
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, -10
+  mov rsi, -10
+  mov rdi, offset .L.data.3
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 10
+  mov rsi, 10
+  mov rdi, offset .L.data.8
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 10
+  mov rsi, 10
+  mov rdi, offset .L.data.9
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.10
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.11
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.12
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.13
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.14
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.15
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.16
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.17
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.18
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.19
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.20
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.21
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.22
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.23
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.24
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, 0
+  mov rdi, offset .L.data.25
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 3
+  mov rdi, offset .L.data.26
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 3
+  add rsi, 5
+  mov rdi, offset .L.data.27
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 3
+  mov rdi, offset .L.data.28
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 3
+  add rsi, 5
+  mov rdi, offset .L.data.2
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 3
+  mov rdi, offset .L.data.29
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 3
+  add rsi, 5
+  mov rdi, offset .L.data.30
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 3
+  mov rax, 0
+  call ret3
+  mov rcx, rax
+  mov rsi, offset .L.data.31
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 0
+  mov rsi, 3
+  mov rdi, offset .L.data.32
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 0
+  mov rsi, 3
+  mov rdi, offset .L.data.33
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 0
+  mov rsi, 2
+  mov rdi, offset .L.data.34
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 0
+  mov rsi, 2
+  mov rdi, offset .L.data.35
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  mov rsi, 0
+  mov rsi, 5
+  mov rdi, 0
+  imul rdi, rsi
+  mov rdi, offset .L.data.36
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 65536
+  mov rsi, 65536
+  imul rsi, 65536
+  mov rdi, 65536
+  mov rax, rsi
+  cqo
+  idiv rdi
+  mov rsi, rax
+  mov rdi, offset .L.data.37
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, -3
+  mov rsi, -3
+  mov rdi, offset .L.data.38
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  mov rsi, 0
+  mov rsi, 5
+  mov rdi, offset .L.data.39
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 1
+  mov rsi, 2
+  mov rsi, 3
+  mov rdi, offset .L.data.40
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 10
+  mov rsi, 0
+  mov rsi, 0
+.L.main.2:
+  cmp rsi, 10
+  jge .L.main.4
+.L.main.3:
+  add rsi, 1
+  jmp .L.main.2
+.L.main.4:
+  mov rdi, offset .L.data.41
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 55
+  mov rsi, 0
+  mov rdi, 0
+.L.main.5:
+  cmp rsi, 10
+  setle r8b
+  movzx r8, r8b
+  cmp r8, 0
+  je .L.main.7
+.L.main.6:
+  add rdi, rsi
+  add rsi, 1
+  jmp .L.main.5
+.L.main.7:
+  mov rsi, offset .L.data.42
+  mov rdx, rsi
+  mov rsi, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 55
+  mov rsi, 0
+  mov rdi, 0
+  mov rsi, 0
+.L.main.8:
+  cmp rsi, 10
+  setle r8b
+  movzx r8, r8b
+  cmp r8, 0
+  je .L.main.10
+.L.main.9:
+  add rdi, rsi
+  add rsi, 1
+  jmp .L.main.8
+.L.main.10:
+  mov rsi, offset .L.data.43
+  mov rdx, rsi
+  mov rsi, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 8
+  mov rcx, 3
+  mov rsi, 5
+  mov rdi, rcx
+  mov rax, 0
+  call add2
+  mov rcx, rax
+  mov rsi, offset .L.data.44
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 2
+  mov rcx, 5
+  mov rsi, 3
+  mov rdi, rcx
+  mov rax, 0
+  call sub2
+  mov rcx, rax
+  mov rsi, offset .L.data.45
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 21
+  mov rcx, 1
+  mov rsi, 2
+  mov rdi, 3
+  mov r8, 4
+  mov r9, 5
+  mov r10, 6
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rcx, r8
+  mov r8, r9
+  mov r9, r10
+  mov rax, 0
+  call add6
+  mov rcx, rax
+  mov rsi, offset .L.data.46
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 4
+  mov rcx, 1
+  mov rsi, 2
+  mov rdi, 3
+  mov r8, 4
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rcx, r8
+  mov rax, 0
+  call last_of4
+  mov rcx, rax
+  mov rsi, offset .L.data.47
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 55
+  mov rcx, 9
+  mov rdi, rcx
+  mov rax, 0
+  call fib
+  mov rcx, rax
+  mov rsi, offset .L.data.48
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 55
+  mov rcx, 10
+  mov rdi, rcx
+  mov rax, 0
+  call sum_to
+  mov rcx, rax
+  mov rsi, offset .L.data.49
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 7
+  mov rcx, 7
+  mov rdi, rcx
+  mov rax, 0
+  call count_to
+  mov rcx, rax
+  mov rsi, offset .L.data.50
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 9
+  mov rcx, 4
+  mov rdi, rcx
+  mov rax, 0
+  call leaf_array
+  mov rcx, rax
+  mov rsi, offset .L.data.51
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, -56
+  mov rcx, 0
+  mov rdi, rcx
+  mov rax, 0
+  call char_wrap
+  mov rcx, rax
+  mov rsi, offset .L.data.52
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 44
+  mov rcx, 100
+  mov rdi, rcx
+  mov rax, 0
+  call char_wrap
+  mov rcx, rax
+  mov rsi, offset .L.data.53
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 1010011
+  mov rcx, 1
+  mov rsi, 2
+  mov rdi, rcx
+  mov rax, 0
+  call compare_all
+  mov rcx, rax
+  mov rsi, offset .L.data.54
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 110100
+  mov rcx, 2
+  mov rsi, 2
+  mov rdi, rcx
+  mov rax, 0
+  call compare_all
+  mov rcx, rax
+  mov rsi, offset .L.data.55
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 1001100
+  mov rcx, 3
+  mov rsi, 2
+  mov rdi, rcx
+  mov rax, 0
+  call compare_all
+  mov rcx, rax
+  mov rsi, offset .L.data.56
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2808]
+  mov rdi, 3
+  mov [rsi], rdi
+  mov rsi, [rbp-2808]
+  mov rdi, offset .L.data.57
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2800]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2792]
+  lea rdi, [rbp-2800]
+  mov [rsi], rdi
+  mov rsi, [rbp-2792]
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.58
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2776]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2768]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2768]
+  lea rsi, [rbp-2776]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.59
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2760]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2752]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2752]
+  lea rsi, [rbp-2760]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.60
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2744]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2736]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2744]
+  lea rsi, [rbp-2736]
+  sub rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.61
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-2728]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2728]
+  add rsi, 16
+  lea rdi, [rbp-2728]
+  mov r8, 8
+  sub rsi, rdi
+  mov rax, rsi
+  cqo
+  idiv r8
+  mov rsi, rax
+  mov rdi, offset .L.data.62
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2720]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2712]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2712]
+  lea rsi, [rbp-2720]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.63
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2696]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2688]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2696]
+  lea rsi, [rbp-2688]
+  sub rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.64
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2672]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2672]
+  mov rdi, 5
+  mov [rsi], rdi
+  mov rsi, [rbp-2672]
+  mov rdi, offset .L.data.65
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 7
+  lea rsi, [rbp-2656]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2648]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2648]
+  lea rsi, [rbp-2656]
+  add rsi, 8
+  mov rdi, 7
+  mov [rsi], rdi
+  mov rsi, [rbp-2648]
+  mov rdi, offset .L.data.66
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 7
+  lea rsi, [rbp-2640]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2632]
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2640]
+  lea rsi, [rbp-2632]
+  sub rsi, 8
+  mov rdi, 7
+  mov [rsi], rdi
+  mov rsi, [rbp-2640]
+  mov rdi, offset .L.data.67
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 8
+  lea rcx, [rbp-2624]
+  mov rsi, 3
+  mov [rcx], rsi
+  mov rcx, 5
+  lea rsi, [rbp-2624]
+  mov rdi, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call addx
+  mov rcx, rax
+  mov rsi, offset .L.data.68
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2608]
+  mov rdi, 3
+  mov [rsi], rdi
+  mov rsi, [rbp-2608]
+  mov rdi, offset .L.data.69
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2584]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2584]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2584]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  mov rsi, [rbp-2584]
+  mov rdi, offset .L.data.70
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  lea rsi, [rbp-2560]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2560]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2560]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2560]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.71
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2536]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2536]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2536]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2536]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.72
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-2512]
+  add rsi, 16
+  lea rdi, [rbp-2512]
+  mov r8, 8
+  sub rsi, rdi
+  mov rax, rsi
+  cqo
+  idiv r8
+  mov rsi, rax
+  mov rdi, offset .L.data.73
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  lea rsi, [rbp-2480]
+  add rsi, 24
+  lea rdi, [rbp-2480]
+  mov r8, 24
+  sub rsi, rdi
+  mov rax, rsi
+  cqo
+  idiv r8
+  mov rsi, rax
+  mov rdi, offset .L.data.74
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  lea rsi, [rbp-2432]
+  mov rdi, 0
+  mov [rsi], rdi
+  mov rsi, [rbp-2432]
+  mov rdi, offset .L.data.75
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  lea rsi, [rbp-2376]
+  add rsi, 8
+  mov rdi, 1
+  mov [rsi], rdi
+  lea rsi, [rbp-2376]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.76
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-2320]
+  add rsi, 16
+  mov rdi, 2
+  mov [rsi], rdi
+  lea rsi, [rbp-2320]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.77
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2264]
+  add rsi, 24
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2264]
+  add rsi, 24
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.78
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  lea rsi, [rbp-2208]
+  add rsi, 32
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2208]
+  add rsi, 24
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.79
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-2152]
+  add rsi, 40
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2152]
+  add rsi, 24
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.80
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 6
+  lea rsi, [rbp-2096]
+  add rsi, 48
+  mov rdi, 6
+  mov [rsi], rdi
+  lea rsi, [rbp-2096]
+  add rsi, 48
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.81
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-2040]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2040]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2040]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  mov rsi, [rbp-2040]
+  mov rdi, offset .L.data.82
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  lea rsi, [rbp-2016]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-2016]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-2016]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-2016]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.83
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-1992]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-1992]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-1992]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-1992]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.84
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-1968]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-1968]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-1968]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-1968]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.84
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-1944]
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-1944]
+  add rsi, 8
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-1944]
+  add rsi, 16
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-1944]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.85
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  lea rsi, [rbp-1920]
+  mov rdi, 0
+  mov [rsi], rdi
+  mov rsi, [rbp-1920]
+  mov rdi, offset .L.data.86
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  lea rsi, [rbp-1864]
+  add rsi, 8
+  mov rdi, 1
+  mov [rsi], rdi
+  lea rsi, [rbp-1864]
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.87
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-1808]
+  add rsi, 16
+  mov rdi, 2
+  mov [rsi], rdi
+  lea rsi, [rbp-1808]
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.88
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-1752]
+  add rsi, 24
+  mov rdi, 3
+  mov [rsi], rdi
+  lea rsi, [rbp-1752]
+  add rsi, 24
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.89
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  lea rsi, [rbp-1696]
+  add rsi, 32
+  mov rdi, 4
+  mov [rsi], rdi
+  lea rsi, [rbp-1696]
+  add rsi, 24
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.90
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 5
+  lea rsi, [rbp-1640]
+  add rsi, 40
+  mov rdi, 5
+  mov [rsi], rdi
+  lea rsi, [rbp-1640]
+  add rsi, 24
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.91
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 6
+  lea rsi, [rbp-1584]
+  add rsi, 48
+  mov rdi, 6
+  mov [rsi], rdi
+  lea rsi, [rbp-1584]
+  add rsi, 48
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.92
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.93
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.94
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.95
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 32
+  mov rsi, 32
+  mov rdi, offset .L.data.96
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 96
+  mov rsi, 96
+  mov rdi, offset .L.data.97
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 32
+  mov rsi, 32
+  mov rdi, offset .L.data.98
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.99
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 9
+  mov rsi, 9
+  mov rdi, offset .L.data.100
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 9
+  mov rsi, 9
+  mov rdi, offset .L.data.101
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.102
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, offset g1
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.103
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, offset g1
+  mov rsi, 3
+  mov [rcx], rsi
+  mov rcx, 3
+  mov rsi, offset g1
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.103
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, offset g2
+  mov rsi, 0
+  mov [rcx], rsi
+  mov rcx, offset g2
+  add rcx, 8
+  mov rsi, 1
+  mov [rcx], rsi
+  mov rcx, offset g2
+  add rcx, 16
+  mov rsi, 2
+  mov [rcx], rsi
+  mov rcx, offset g2
+  add rcx, 24
+  mov rsi, 3
+  mov [rcx], rsi
+  mov rcx, 0
+  mov rsi, offset g2
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.104
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, offset g2
+  add rsi, 8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.105
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, offset g2
+  add rsi, 16
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.106
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, offset g2
+  add rsi, 24
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.107
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.108
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 32
+  mov rsi, 32
+  mov rdi, offset .L.data.109
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  movsx rsi, sil
+  mov rdi, offset .L.data.110
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  movsx rsi, sil
+  mov rdi, 2
+  movsx rdi, dil
+  mov rdi, offset .L.data.111
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 1
+  movsx rsi, sil
+  mov rsi, 2
+  movsx rsi, sil
+  mov rdi, offset .L.data.112
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 1
+  mov rdi, offset .L.data.113
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 10
+  mov rsi, 10
+  mov rdi, offset .L.data.114
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rbx, 1
+  mov rcx, 7
+  mov rsi, 3
+  mov rdx, 3
+  mov rdi, rcx
+  mov rax, 0
+  call sub_char
+  mov rcx, rax
+  mov rsi, offset .L.data.115
+  mov rdi, rbx
+  mov rdx, rsi
+  mov rsi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 97
+  mov rsi, offset .L.data.116
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.117
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 98
+  mov rsi, offset .L.data.116
+  add rsi, 1
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.118
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 99
+  mov rsi, offset .L.data.116
+  add rsi, 2
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.119
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, offset .L.data.116
+  add rsi, 3
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.120
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 4
+  mov rsi, 4
+  mov rdi, offset .L.data.121
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 7
+  mov rsi, offset .L.data.122
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.123
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, offset .L.data.124
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.125
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 9
+  mov rsi, offset .L.data.126
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.127
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 10
+  mov rsi, offset .L.data.128
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.129
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 11
+  mov rsi, offset .L.data.130
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.131
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 12
+  mov rsi, offset .L.data.132
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.133
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 13
+  mov rsi, offset .L.data.134
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.135
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 27
+  mov rsi, offset .L.data.136
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.137
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  mov rsi, offset .L.data.138
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.139
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 98
+  mov rsi, offset .L.data.140
+  add rsi, 2
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.141
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, offset .L.data.116
+  mov rdi, offset .L.data.116
+  cmp rsi, rdi
+  sete sil
+  movzx rsi, sil
+  mov rdi, offset .L.data.142
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 106
+  mov rsi, offset .L.data.143
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.144
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 107
+  mov rsi, offset .L.data.145
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.146
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 108
+  mov rsi, offset .L.data.147
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.148
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 2
+  mov rdi, 3
+  mov rdi, offset .L.data.149
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 2
+  mov rdi, 3
+  mov rdi, 4
+  mov rdi, offset .L.data.150
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 2
+  mov rsi, 3
+  mov rdi, offset .L.data.151
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-832]
+  add rsi, 16
+  lea rdi, [rbp-832]
+  mov r8, 8
+  sub rsi, rdi
+  mov rax, rsi
+  cqo
+  idiv r8
+  mov rsi, rax
+  mov rdi, offset .L.data.152
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 0
+  lea rdi, [rbp-784]
+  add rsi, rdi
+  mov rdi, 1
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-784]
+  add rsi, rdi
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 0
+  lea rdi, [rbp-784]
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.153
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 0
+  lea rdi, [rbp-768]
+  add rsi, rdi
+  mov rdi, 1
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-768]
+  add rsi, rdi
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-768]
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.154
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  mov rsi, 0
+  lea rdi, [rbp-752]
+  add rsi, rdi
+  mov rdi, 1
+  mov byte ptr [rsi], dil
+  mov rsi, 8
+  lea rdi, [rbp-752]
+  add rsi, rdi
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 16
+  lea rdi, [rbp-752]
+  add rsi, rdi
+  mov rdi, 3
+  mov byte ptr [rsi], dil
+  mov rsi, 0
+  lea rdi, [rbp-752]
+  add rsi, rdi
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.155
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 8
+  lea rdi, [rbp-728]
+  add rsi, rdi
+  mov rdi, 1
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-728]
+  add rsi, rdi
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 16
+  lea rdi, [rbp-728]
+  add rsi, rdi
+  mov rdi, 3
+  mov byte ptr [rsi], dil
+  mov rsi, 8
+  lea rdi, [rbp-728]
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.156
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 0
+  lea rdi, [rbp-704]
+  add rsi, rdi
+  mov rdi, 1
+  mov byte ptr [rsi], dil
+  mov rsi, 8
+  lea rdi, [rbp-704]
+  add rsi, rdi
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 16
+  lea rdi, [rbp-704]
+  add rsi, rdi
+  mov rdi, 3
+  mov byte ptr [rsi], dil
+  mov rsi, 16
+  lea rdi, [rbp-704]
+  add rsi, rdi
+  movsx rsi, byte ptr [rsi]
+  mov rdi, offset .L.data.157
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 0
+  lea rsi, [rbp-680]
+  mov rdi, 0
+  mov [rsi], rdi
+  mov rsi, 0
+  lea rdi, [rbp-680]
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.158
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  lea rsi, [rbp-624]
+  add rsi, 8
+  mov rdi, 1
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-624]
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.159
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  lea rsi, [rbp-568]
+  add rsi, 16
+  mov rdi, 2
+  mov [rsi], rdi
+  mov rsi, 0
+  lea rdi, [rbp-568]
+  mov r8, 16
+  add rdi, r8
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.160
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  lea rsi, [rbp-512]
+  add rsi, 24
+  mov rdi, 3
+  mov [rsi], rdi
+  mov rsi, 8
+  lea rdi, [rbp-512]
+  mov r8, 16
+  add rdi, r8
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.161
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 6
+  lea rsi, [rbp-456]
+  mov rdi, 0
+  lea r8, [rbp-456]
+  add rdi, r8
+  mov r8, 6
+  mov [rdi], r8
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.162
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 7
+  lea rsi, [rbp-384]
+  mov rdi, 24
+  lea r8, [rbp-384]
+  add rdi, r8
+  mov r8, 7
+  mov [rdi], r8
+  add rsi, 24
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.163
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 6
+  mov rsi, 0
+  mov rdi, 0
+  lea r8, [rbp-312]
+  add rdi, r8
+  add rsi, rdi
+  mov rdi, 6
+  mov [rsi], rdi
+  mov rsi, 0
+  mov rdi, 0
+  lea r8, [rbp-312]
+  add rdi, r8
+  add rsi, rdi
+  mov rsi, [rsi]
+  mov rdi, offset .L.data.164
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 8
+  mov rsi, 8
+  mov rdi, offset .L.data.165
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 16
+  mov rsi, 16
+  mov rdi, offset .L.data.166
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 24
+  mov rsi, 24
+  mov rdi, offset .L.data.167
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 32
+  mov rsi, 32
+  mov rdi, offset .L.data.168
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 48
+  mov rsi, 48
+  mov rdi, offset .L.data.169
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 2
+  mov rdi, offset .L.data.170
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 16
+  mov rsi, 16
+  mov rdi, offset .L.data.171
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 16
+  mov rsi, 16
+  mov rdi, offset .L.data.172
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 15
+  lea rsi, [rbp-136]
+  lea rdi, [rbp-121]
+  mov r11, rsi
+  mov rsi, rdi
+  sub rsi, r11
+  mov rdi, offset .L.data.173
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 1
+  lea rsi, [rbp-97]
+  lea rdi, [rbp-96]
+  mov r11, rsi
+  mov rsi, rdi
+  sub rsi, r11
+  mov rdi, offset .L.data.174
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 16
+  mov rsi, 16
+  mov rdi, offset .L.data.175
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 16
+  mov rsi, 16
+  mov rdi, offset .L.data.176
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 2
+  mov rsi, 2
+  mov rdi, offset .L.data.177
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, 3
+  mov rsi, 1
+  mov rdi, 0
+  lea r8, [rbp-8]
+  add rdi, r8
+  mov r8, 2
+  mov [rdi], r8
+  mov rdi, 0
+  lea r8, [rbp-8]
+  add rdi, r8
+  mov rdi, [rdi]
+  add rsi, rdi
+  mov rdi, offset .L.data.178
+  mov rdx, rdi
+  mov rdi, rcx
+  mov rax, 0
+  call assert
+  mov rcx, rax
+  mov rcx, offset .L.data.179
+  mov rdi, rcx
+  mov rax, 0
+  call printf
+  mov rcx, rax
+  mov rax, 0
+.L.main.11:
+.L.return.main:
+  mov rbx, [rbp-2992]
+  mov rsp, rbp
+  pop rbp
+  ret
+.section .rodata.str1.1,"aMS",@progbits,1
+.L.data.179:
+  .string "OK\012"
+.L.data.178:
+  .string "struct t {int x;}; int t = 1; struct t y; y.x = 2; t + y.x;"
+.L.data.177:
+  .string "struct t {char a[2];}; { struct t {char a[4];}; } struct t y; sizeof(y);"
+.L.data.176:
+  .string "struct t {int a; int b;}; struct t y; sizeof(y);"
+.L.data.175:
+  .string "struct t {int a; int b;} x; struct t y; sizeof(y);"
+.L.data.174:
+  .string "char x; int y; int a = &x; int b = &y; b - a;"
+.L.data.173:
+  .string "int x; char y; int a = &x; int b = &y; b - a;"
+.L.data.172:
+  .string "struct {int a; char b;} x; sizeof(x);"
+.L.data.171:
+  .string "struct {char a; int b;} x; sizeof(x);"
+.L.data.170:
+  .string "struct {char a; char b;} x; sizeof(x);"
+.L.data.169:
+  .string "struct {int a[3];} x[2]; sizeof(x)};"
+.L.data.168:
+  .string "struct {int a;} x[4]; sizeof(x);"
+.L.data.167:
+  .string "struct {int a[3];} x; sizeof(x);"
+.L.data.166:
+  .string "struct {int a; int b;} x; sizeof(x);"
+.L.data.165:
+  .string "struct {int a;} x; sizeof(x);"
+.L.data.164:
+  .string "struct { struct { int b; } a; } x; x.a.b = 6; x.a.b;"
+.L.data.163:
+  .string "struct {int a[3]; int b[5];} x; int *p = &x; x.b[0] = 7; p[3];"
+.L.data.162:
+  .string "struct {int a[3]; int b[5];} x; int *p = &x; x.a[0] = 6; p[0];"
+.L.data.161:
+  .string "struct {int a; int b;} x[3]; int *p = x; p[3] = 3; x[1].b;"
+.L.data.160:
+  .string "struct {int a; int b;} x[3]; int *p = x; p[2] = 2; x[1].a;"
+.L.data.159:
+  .string "struct {int a; int b;} x[3]; int *p = x; p[1] = 1; x[0].b;"
+.L.data.158:
+  .string "struct {int a; int b;} x[3]; int *p = x; p[0] = 0; x[0].a;"
+.L.data.157:
+  .string "struct {char a; int b; char c;} x; x.a = 1; x.b = 2; x.c = 3; x.c;"
+.L.data.156:
+  .string "struct {char a; int b; char c;} a; x.b = x; x.a = 2; x.b = 3; x.b;"
+.L.data.155:
+  .string "struct {char a; int b; char c;} x; x.a = 1; x.b = 2; x.c = 3; x.a;"
+.L.data.154:
+  .string "struct {int a; int b;} x; x.a = 1; x.b = 2; x.b;"
+.L.data.153:
+  .string "struct {int a; int b;} x; x.a = 1; x.b = 2; x.a;"
+.L.data.152:
+  .string "int x[5]; int *y = x + 2; y - x;"
+.L.data.151:
+  .string "int x=2; { x=3; } x;"
+.L.data.150:
+  .string "int x=2; { int x=3; } int y=4; x;"
+.L.data.149:
+  .string "int x=2; { int x=3; } x;"
+.L.data.148:
+  .string "\"\\l\"[0]"
+.L.data.147:
+  .string "l"
+.L.data.146:
+  .string "\"\\k\"[0]"
+.L.data.145:
+  .string "k"
+.L.data.144:
+  .string "\"\\j\"[0]"
+.L.data.143:
+  .string "j"
+.L.data.142:
+  .string "\"abc\" == \"abc\""
+.L.data.141:
+  .string "\"a\\0b\"[2]"
+.L.data.139:
+  .string "\"\\0\"[0]"
+.L.data.137:
+  .string "\"\\e\"[0]"
+.L.data.136:
+  .string "\033"
+.L.data.135:
+  .string "\"\\r\"[0]"
+.L.data.134:
+  .string "\015"
+.L.data.133:
+  .string "\"\\f\"[0]"
+.L.data.132:
+  .string "\014"
+.L.data.131:
+  .string "\"\\v\"[0]"
+.L.data.130:
+  .string "\013"
+.L.data.129:
+  .string "\"\\n\"[0]"
+.L.data.128:
+  .string "\012"
+.L.data.127:
+  .string "\"\\t\"[0]"
+.L.data.126:
+  .string "\011"
+.L.data.125:
+  .string "\"\\b\"[0]"
+.L.data.124:
+  .string "\010"
+.L.data.123:
+  .string "\"\\a\"[0]"
+.L.data.122:
+  .string "\007"
+.L.data.121:
+  .string "sizeof(\"abc\")"
+.L.data.120:
+  .string "\"abc\"[3]"
+.L.data.119:
+  .string "\"abc\"[2]"
+.L.data.118:
+  .string "\"abc\"[1]"
+.L.data.117:
+  .string "\"abc\"[0]"
+.L.data.116:
+  .string "abc"
+.L.data.115:
+  .string "sub_char(7, 3, 3)"
+.L.data.114:
+  .string "char x[10]; sizeof(x);"
+.L.data.113:
+  .string "char x; sizeof(x);"
+.L.data.112:
+  .string "char x=1; char y=2; y;"
+.L.data.111:
+  .string "char x=1; char y=2; x;"
+.L.data.110:
+  .string "char x=1; x;"
+.L.data.109:
+  .string "sizeof(g2)"
+.L.data.108:
+  .string "sizeof(g1)"
+.L.data.107:
+  .string "g2[3]"
+.L.data.106:
+  .string "g2[2]"
+.L.data.105:
+  .string "g2[1]"
+.L.data.104:
+  .string "g2[0]"
+.L.data.103:
+  .string "g1"
+.L.data.102:
+  .string "int x[3][4]; sizeof(**x + 1);"
+.L.data.101:
+  .string "int x[3][4]; sizeof **x + 1;"
+.L.data.100:
+  .string "int x[3][4]; sizeof(**x) + 1;"
+.L.data.99:
+  .string "int x[3][4]; sizeof(**x);"
+.L.data.98:
+  .string "int x[3][4]; sizeof(*x);"
+.L.data.97:
+  .string "int x[3][4]; sizeof(x);"
+.L.data.96:
+  .string "int x[4]; sizeof(x);"
+.L.data.95:
+  .string "int *x; sizeof(x);"
+.L.data.94:
+  .string "int x; sizeof x;"
+.L.data.93:
+  .string "int x; sizeof(x);"
+.L.data.92:
+  .string "int x[2][3]; int *y=x; y[6]=6; x[2][0];"
+.L.data.91:
+  .string "int x[2][3]; int *y=x; y[5]=5; x[1][2];"
+.L.data.90:
+  .string "int x[2][3]; int *y=x; y[4]=4; x[1][1];"
+.L.data.89:
+  .string "int x[2][3]; int *y=x; y[3]=3; x[1][0];"
+.L.data.88:
+  .string "int x[2][3]; int *y=x; y[2]=2; x[0][2];"
+.L.data.87:
+  .string "int x[2][3]; int *y=x; y[1]=1; x[0][1];"
+.L.data.86:
+  .string "int x[2][3]; int *y=x; y[0]=0; x[0][0];"
+.L.data.85:
+  .string "int x[3]; *x=3; x[1]=4; 2[x]=5; *(x+2);"
+.L.data.84:
+  .string "int x[3]; *x=3; x[1]=4; x[2]=5; *(x+2);"
+.L.data.83:
+  .string "int x[3]; *x=3; x[1]=4; x[2]=5; *(x+1);"
+.L.data.82:
+  .string "int x[3]; *x=3; x[1]=4; x[2]=5; *x;"
+.L.data.81:
+  .string "int x[2][3]; int *y=x; *(y+6)=6; **(x+2);"
+.L.data.80:
+  .string "int x[2][3]; int *y=x; *(y+5)=5; *(*(x+1)+2);"
+.L.data.79:
+  .string "int x[2][3]; int *y=x; *(y+4)=4; *(*(x+1)+1);"
+.L.data.78:
+  .string "int x[2][3]; int *y=x; *(y+3)=3; **(x+1);"
+.L.data.77:
+  .string "int x[2][3]; int *y=x; *(y+2)=2; *(*x+2);"
+.L.data.76:
+  .string "int x[2][3]; int *y=x; *(y+1)=1; *(*x+1);"
+.L.data.75:
+  .string "int x[2][3]; int *y=x; *y=0; **x;"
+.L.data.74:
+  .string "int x[2][3]; (x+1)-x;"
+.L.data.73:
+  .string "int x[3]; int *y=x+2; y-x;"
+.L.data.72:
+  .string "int x[3]; *x=3; *(x+1)=4; *(x+2)=5; *(x+2);"
+.L.data.71:
+  .string "int x[3]; *x=3; *(x+1)=4; *(x+2)=5; *(x+1);"
+.L.data.70:
+  .string "int x[3]; *x=3; *(x+1)=4; *(x+2)=5; *x;"
+.L.data.69:
+  .string "int x[2]; int *y=&x; *y=3; *x;"
+.L.data.68:
+  .string "int x=3; int y=5; addx(&x, y);"
+.L.data.67:
+  .string "int x=3; int y=5; &x; *(&y-1)=7; x;"
+.L.data.66:
+  .string "int x=3; int y=5; &y; *(&x+1)=7; y;"
+.L.data.65:
+  .string "int x=3; int *y=&x; *y=5; x;"
+.L.data.64:
+  .string "int x=3; int y=5; &x; int *z=&y; *(z-1);"
+.L.data.63:
+  .string "int x=3; int y=5; &y; int *z=&x; *(z+1);"
+.L.data.62:
+  .string "int x=3; (&x+2)-&x;"
+.L.data.61:
+  .string "int x=3; int y=5; &x; *(&y-1);"
+.L.data.60:
+  .string "int x=3; int y=5; &y; *(1+&x);"
+.L.data.59:
+  .string "int x=3; int y=5; &y; *(&x+1);"
+.L.data.58:
+  .string "int x=3; int *y=&x; int **z=&y; **z;"
+.L.data.57:
+  .string "int x=3; *&x;"
+.L.data.56:
+  .string "compare_all(3, 2)"
+.L.data.55:
+  .string "compare_all(2, 2)"
+.L.data.54:
+  .string "compare_all(1, 2)"
+.L.data.53:
+  .string "char_wrap(100)"
+.L.data.52:
+  .string "char_wrap(0)"
+.L.data.51:
+  .string "leaf_array(4)"
+.L.data.50:
+  .string "count_to(7)"
+.L.data.49:
+  .string "sum_to(10)"
+.L.data.48:
+  .string "fib(9)"
+.L.data.47:
+  .string "last_of4(1,2,3,4)"
+.L.data.46:
+  .string "add6(1,2,3,4,5,6)"
+.L.data.45:
+  .string "sub(5, 3)"
+.L.data.44:
+  .string "add(3, 5)"
+.L.data.43:
+  .string "int i=0; int j=0; for (i=0; i<=10; i=i+1) j=i+j; j;"
+.L.data.42:
+  .string "int i=0; int j=0; while(i<=10) {j=i+j; i=i+1;} j;"
+.L.data.41:
+  .string "int i=0; i=0; while(i<10) i=i+1; i;"
+.L.data.40:
+  .string "1; {2;} 3;"
+.L.data.39:
+  .string "int i=0; for (i=5; 0; i=i+1) i=9; i;"
+.L.data.38:
+  .string "-7/2"
+.L.data.37:
+  .string "65536*65536/65536"
+.L.data.36:
+  .string "int x=0; (x=5)*0; x;"
+.L.data.35:
+  .string "int x=0; if (2-1) x=2; else x=3; x;"
+.L.data.34:
+  .string "int x=0; if (1) x=2; else x=3; x;"
+.L.data.33:
+  .string "int x=0; if (1-1) x=2; else x=3; x;"
+.L.data.32:
+  .string "int x=0; if (0) x=2; else x=3; x;"
+.L.data.31:
+  .string "ret3();"
+.L.data.30:
+  .string "int foo123=3; int bar=5; foo123+bar;"
+.L.data.29:
+  .string "int foo=3; foo;"
+.L.data.28:
+  .string "int a=3; a;"
+.L.data.27:
+  .string "int a; int z; a=3; z=5; a+z;"
+.L.data.26:
+  .string "int a; a=3; a;"
+.L.data.25:
+  .string "1>=2"
+.L.data.24:
+  .string "1>=1"
+.L.data.23:
+  .string "1>=0"
+.L.data.22:
+  .string "1>2"
+.L.data.21:
+  .string "1>1"
+.L.data.20:
+  .string "1>0"
+.L.data.19:
+  .string "2<=1"
+.L.data.18:
+  .string "1<=1"
+.L.data.17:
+  .string "0<=1"
+.L.data.16:
+  .string "2<1"
+.L.data.15:
+  .string "1<1"
+.L.data.14:
+  .string "0<1"
+.L.data.13:
+  .string "42!=42"
+.L.data.12:
+  .string "0!=1"
+.L.data.11:
+  .string "42==42"
+.L.data.10:
+  .string "0==1"
+.L.data.9:
+  .string "- - +10"
+.L.data.8:
+  .string "- -10"
+.L.data.7:
+  .string "(3+5)/2"
+.L.data.6:
+  .string "5*(9-6)"
+.L.data.5:
+  .string " 12 + 34 - 5 "
+.L.data.4:
+  .string "42"
+.L.data.3:
+  .string "0"
+.L.data.2:
+  .string "int a=3; int z=5; a+z;"
+.L.data.1:
+  .string "%s => %d expected but got %d\012"
+.L.data.0:
+  .string "%s => %d\012"
+.section .rodata
+.L.data.140:
+  .ascii "a\000b\000"
+.L.data.138:
+  .ascii "\000\000"
+.bss
+  .align 8
+g2:
+  .zero 32
+  .align 8
+g1:
+  .zero 8
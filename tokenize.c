@@ -1,21 +1,42 @@
 #include "9cc.h"
 
-char *filename;
-char *user_input;
-Token *token;
+// Records a diagnostic and abandons the running compilation. Outside of
+// a compilation the message is printed and the process exits.
+static void report(char *msg, size_t len) {
+  if (!cc || !cc->bail) {
+    fprintf(stderr, "%s\n", msg);
+    exit(1);
+  }
+
+  Diag *diag = arena_alloc(&cc->arena, sizeof(Diag));
+  diag->msg = arena_alloc(&cc->arena, len + 1);
+  memcpy(diag->msg, msg, len);
+  free(msg);
+
+  Diag **tail = &cc->diags;
+  while (*tail)
+    tail = &(*tail)->next;
+  *tail = diag;
+  longjmp(*cc->bail, 1);
+}
 
 void error(char *fmt, ...) {
+  char *buf;
+  size_t len;
+  FILE *out = open_memstream(&buf, &len);
+
   va_list ap;
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
-  fprintf(stderr, "\n");
-  exit(1);
+  vfprintf(out, fmt, ap);
+  va_end(ap);
+  fclose(out);
+  report(buf, len);
 }
 
 void verror_at(char *loc, char *fmt, va_list ap) {
   // Find a line containing `loc`
   char *line = loc;
-  while (user_input < line && line[-1] != '\n')
+  while (cc->user_input < line && line[-1] != '\n')
     line--;
 
   char *end = loc;
@@ -24,21 +45,25 @@ void verror_at(char *loc, char *fmt, va_list ap) {
 
   // Get a line number.
   int line_num = 1;
-  for (char *p = user_input; p < line; p++)
+  for (char *p = cc->user_input; p < line; p++)
     if (*p == '\n')
       line_num++;
 
+  char *buf;
+  size_t len;
+  FILE *out = open_memstream(&buf, &len);
+
   // Print out the line.
-  int indent = fprintf(stderr, "%s:%d ", filename, line_num);
-  fprintf(stderr, "%.*s\n", (int)(end - line), line);
+  int indent = fprintf(out, "%s:%d ", cc->filename, line_num);
+  fprintf(out, "%.*s\n", (int)(end - line), line);
 
   // Show out the line.
   int pos = loc - line + indent;
-  fprintf(stderr, "%*s", pos, "");
-  fprintf(stderr, "^ ");
-  vfprintf(stderr, fmt, ap);
-  fprintf(stderr, "\n");
-  exit(1);
+  fprintf(out, "%*s", pos, "");
+  fprintf(out, "^ ");
+  vfprintf(out, fmt, ap);
+  fclose(out);
+  report(buf, len);
 }
 
 void error_at(char *loc, char *fmt, ...) {
@@ -54,65 +79,124 @@ void error_tok(Token *tok, char *fmt, ...) {
 }
 
 Token *consume(char *op) {
-  if (token->kind != TK_RESERVED ||
-      strlen(op) != token->len ||
-      memcmp(token->str, op, token->len))
+  if (cc->token->kind != TK_RESERVED ||
+      strlen(op) != cc->token->len ||
+      memcmp(cc->token->str, op, cc->token->len))
     return NULL;
-  Token *t = token;
-  token = token->next;
+  Token *t = cc->token;
+  cc->token++;
   return t;
 }
 
 Token *peek(char *s) {
-  if (token->kind != TK_RESERVED || strlen(s) != token->len ||
-      strncmp(token->str, s, token->len))
+  if (cc->token->kind != TK_RESERVED || strlen(s) != cc->token->len ||
+      strncmp(cc->token->str, s, cc->token->len))
     return NULL;
-  return token;
+  return cc->token;
 }
 
 Token *consume_ident(void) {
-  if (token->kind != TK_IDENT)
+  if (cc->token->kind != TK_IDENT)
     return NULL;
-  Token *t = token;
-  token = token->next;
+  Token *t = cc->token;
+  cc->token++;
   return t;
 }
 
 void expect(char *s) {
   if (!peek(s))
-    error_tok(token, "expected \"%s\"", s);
-  token = token->next;
+    error_tok(cc->token, "expected \"%s\"", s);
+  cc->token++;
 }
 
 int expect_number() {
-  if (token->kind != TK_NUM)
-    error_tok(token, "Int is expected, but it is not Int value");
-  int val = token->val;
-  token = token->next;
+  if (cc->token->kind != TK_NUM)
+    error_tok(cc->token, "Int is expected, but it is not Int value");
+  int val = cc->token->val;
+  cc->token++;
   return val;
 }
 
 char *expect_ident(void) {
-  if (token->kind != TK_IDENT)
-    error_tok(token, "Identifier is expected");
-  char *s = strndup(token->str, token->len);
-  token = token->next;
-  return s;
+  if (cc->token->kind != TK_IDENT)
+    error_tok(cc->token, "Identifier is expected");
+  return (cc->token++)->name;
 }
 
 bool at_eof() {
-  return token->kind == TK_EOF;
+  return cc->token->kind == TK_EOF;
 }
 
-Token *new_token(TokenKind kind, Token *cur, char *str, int len) {
-  Token *tok = calloc(1, sizeof(Token));
-  tok->kind = kind;
-  tok->str = str;
-  tok->len = len;
-  cur->next = tok;
+// Appends a token. The returned pointer is only valid until the next
+// call, as the array may move when it grows.
+static Token *new_token(TokenKind kind, char *str, int len) {
+  if (cc->tokens_len == cc->tokens_cap) {
+    cc->tokens_cap = cc->tokens_cap ? cc->tokens_cap * 2 : 4096;
+    cc->tokens = realloc(cc->tokens, sizeof(Token) * cc->tokens_cap);
+  }
+
+  Token *tok = &cc->tokens[cc->tokens_len++];
+  *tok = (Token){.str = str, .len = len, .kind = kind};
   return tok;
 }
 
+// Identifiers are interned: each distinct spelling is stored exactly
+// once per Compiler, so two names are equal if and only if their
+// pointers are.
+
+static uint32_t fnv_hash(char *s, int len) {
+  uint32_t h = 2166136261u;
+  for (int i = 0; i < len; i++)
+    h = (h ^ (unsigned char)s[i]) * 16777619;
+  return h;
+}
+
+static InternEntry *intern_slot(InternEntry *map, int cap, char *s, int len, uint32_t h) {
+  for (uint32_t i = h;; i++) {
+    InternEntry *e = &map[i & (cap - 1)];
+    if (!e->str || (e->hash == h && e->len == len && !memcmp(e->str, s, len)))
+      return e;
+  }
+}
+
+static void grow_intern_map(void) {
+  int cap = cc->intern_cap ? cc->intern_cap * 2 : 4096;
+  InternEntry *map = calloc(cap, sizeof(InternEntry));
+  for (int i = 0; i < cc->intern_cap; i++) {
+    InternEntry *e = &cc->intern_map[i];
+    if (e->str)
+      *intern_slot(map, cap, e->str, e->len, e->hash) = *e;
+  }
+  free(cc->intern_map);
+  cc->intern_map = map;
+  cc->intern_cap = cap;
+}
+
+// Returns the unique NUL-terminated copy of the `len` bytes at `s`.
+char *intern(char *s, int len) {
+  if (cc->intern_used * 2 >= cc->intern_cap)
+    grow_intern_map();
+
+  uint32_t h = fnv_hash(s, len);
+  InternEntry *e = intern_slot(cc->intern_map, cc->intern_cap, s, len, h);
+  if (e->str)
+    return e->str;
+
+  if (cc->intern_buf_left < len + 1) {
+    cc->intern_buf_left = len + 1 < 64 * 1024 ? 64 * 1024 : len + 1;
+    cc->intern_buf = arena_alloc(&cc->arena, cc->intern_buf_left);
+  }
+  char *str = cc->intern_buf;
+  memcpy(str, s, len);
+  str[len] = '\0';
+  cc->intern_buf += len + 1;
+  cc->intern_buf_left -= len + 1;
+
+  *e = (InternEntry){str, len, h};
+  cc->intern_used++;
+  return str;
+}
+
 bool startswith(char *p, char *q) {
   return memcmp(p, q, strlen(q)) == 0;
 }
@@ -125,23 +209,76 @@ bool is_alnum(char c) {
   return is_alpha(c) || ('0' <= c && c <= '9');
 }
 
-char *starts_with_reserved(char *p) {
-  // Keyword
-  static char *kw[] = {"return", "if", "else", "while", "for", "int", "char", "sizeof", "struct"};
+// Keywords and multi-letter punctuators.
+static char *kw[] = {"return", "if", "else", "while", "for", "int", "char", "sizeof", "struct"};
+static char *ops[] = {"==", "!=", "<=", ">="};
+
+// Reserved words are recognized through a perfect hash table built from
+// kw[] and ops[] on first use: a seed is searched for under which no two
+// entries collide, so a lookup is one hash, one probe and one compare.
+#define RESERVED_MAP_SIZE 64
+
+typedef struct {
+  char *str;
+  int len;
+} Reserved;
+
+static Reserved reserved_map[RESERVED_MAP_SIZE];
+static uint32_t reserved_seed;
+static int ops_maxlen;
+
+static uint32_t reserved_hash(char *p, int len) {
+  uint32_t h = reserved_seed;
+  for (int i = 0; i < len; i++)
+    h = (h ^ (unsigned char)p[i]) * 16777619;
+  return h & (RESERVED_MAP_SIZE - 1);
+}
 
-  for (int i = 0; i < sizeof(kw) / sizeof(*kw); i++) {
-    int len = strlen(kw[i]);
-    if (startswith(p, kw[i]) && !is_alnum(p[len]))
-      return kw[i];
-  }
+static bool add_reserved(char *s) {
+  int len = strlen(s);
+  Reserved *r = &reserved_map[reserved_hash(s, len)];
+  if (r->str)
+    return false;
+  r->str = s;
+  r->len = len;
+  return true;
+}
 
-  char *ops[] = {"==", "!=", "<=", ">="};
+static void init_reserved_map(void) {
+  for (reserved_seed = 2166136261u;; reserved_seed++) {
+    memset(reserved_map, 0, sizeof(reserved_map));
+    bool ok = true;
+    for (int i = 0; ok && i < sizeof(kw) / sizeof(*kw); i++)
+      ok = add_reserved(kw[i]);
+    for (int i = 0; ok && i < sizeof(ops) / sizeof(*ops); i++)
+      ok = add_reserved(ops[i]);
+    if (ok)
+      break;
+  }
 
   for (int i = 0; i < sizeof(ops) / sizeof(*ops); i++)
-    if (startswith(p, ops[i]))
-      return ops[i];
+    if (ops_maxlen < strlen(ops[i]))
+      ops_maxlen = strlen(ops[i]);
+}
 
-  return NULL;
+static bool is_reserved(char *p, int len) {
+  Reserved *r = &reserved_map[reserved_hash(p, len)];
+  return r->len == len && !memcmp(r->str, p, len);
+}
+
+// Returns the length of the punctuator at `p`, or 0 if there is none.
+static int punct_len(char *p) {
+  if (!ispunct(*p))
+    return 0;
+
+  for (int len = ops_maxlen; len > 1; len--) {
+    bool all_punct = true;
+    for (int i = 1; i < len && all_punct; i++)
+      all_punct = ispunct(p[i]);
+    if (all_punct && is_reserved(p, len))
+      return len;
+  }
+  return 1;
 }
 
 static char get_escape_char(char c) {
@@ -159,7 +296,7 @@ static char get_escape_char(char c) {
   }
 }
 
-static Token *read_string_literal(Token *cur, char *start) {
+static Token *read_string_literal(char *start) {
   char *p = start + 1;
   char buf[1024];
   int len = 0;
@@ -180,81 +317,86 @@ static Token *read_string_literal(Token *cur, char *start) {
     }
   }
 
-  Token *tok = new_token(TK_STR, cur, start, p - start + 1);
-  tok->contents = malloc(len + 1);
+  Token *tok = new_token(TK_STR, start, p - start + 1);
+  tok->contents = arena_alloc(&cc->arena, len + 1);
   memcpy(tok->contents, buf, len);
   tok->contents[len] = '\0';
   tok->cont_len = len + 1;
   return tok;
 }
 
+static void init_lexer(void) {
+  init_reserved_map();
+  scan_init();
+}
+
 Token *tokenize() {
-  char *p = user_input;
-  Token head = {};
-  Token *cur = &head;
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, init_lexer);
+
+  char *p = cc->user_input;
 
   while (*p) {
     // skip spaces
     if (isspace(*p)) {
-      p++;
+      p = skip_space(p);
       continue;
     }
 
     // skip line comments
     if (startswith(p, "//")) {
-      p += 2;
-      while (*p != '\n')
-        p++;
+      p = find_line_end(p + 2);
       continue;
     }
 
     // skip block comments
     if (startswith(p, "/*")) {
-      char *q = strstr(p + 2, "*/");
-      if (!q)
+      char *q = find_comment_end(p + 2);
+      if (!*q)
         error_at(p, "Unclosed block comment");
       p = q + 2;
       continue;
     }
 
     if (*p == '"') {
-      cur = read_string_literal(cur, p);
-      p += cur->len;
-      continue;
-    }
-
-    char *kw = starts_with_reserved(p);
-    if (kw) {
-      int len = strlen(kw);
-      cur = new_token(TK_RESERVED, cur, p, len);
-      p += len;
+      p += read_string_literal(p)->len;
       continue;
     }
 
+    // Keywords and identifiers
     if (is_alpha(*p)) {
-      char *q = p++;
-      while (is_alnum(*p))
-        p++;
-      cur = new_token(TK_IDENT, cur, q, p - q);
+      char *q = p;
+      p = skip_ident(p + 1);
+      if (is_reserved(q, p - q))
+        new_token(TK_RESERVED, q, p - q);
+      else
+        new_token(TK_IDENT, q, p - q)->name = intern(q, p - q);
       continue;
     }
 
-    if (ispunct(*p)) {
-      cur = new_token(TK_RESERVED, cur, p++, 1);
+    int len = punct_len(p);
+    if (len) {
+      new_token(TK_RESERVED, p, len);
+      p += len;
       continue;
     }
 
     if (isdigit(*p)) {
-      cur = new_token(TK_NUM, cur, p, 0);
       char *q = p;
-      cur->val = strtol(p, &p, 10);
-      cur->len = p - q;
+      p = skip_digits(p);
+      unsigned long val = 0;
+      for (char *d = q; d < p; d++) {
+        val = val * 10 + (*d - '0');
+        if (val > INT_MAX)
+          error_at(q, "number too large");
+      }
+      new_token(TK_NUM, q, p - q)->val = val;
       continue;
     }
 
     error_at(p, "Invalid token");
   }
 
-  new_token(TK_EOF, cur, p, 0);
-  return head.next;
+  new_token(TK_EOF, p, 0);
+  return cc->tokens;
 }
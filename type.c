@@ -12,43 +12,77 @@ int align_to(int n, int align) {
 }
 
 static Type *new_type(TypeKind kind, int size, int align) {
-  Type *ty = calloc(1, sizeof(Type));
+  Type *ty = arena_alloc(&cc->arena, sizeof(Type));
   ty->kind = kind;
   ty->size = size;
   ty->align = align;
   return ty;
 }
 
-Type *pointer_to(Type *base) {
-  Type *ty = new_type(TY_PTR, 8, 8);
-  ty->base = base;
-  return ty;
+// Derived types are hash-consed: each distinct (kind, base, length)
+// exists exactly once per Compiler, so two pointer or array types are
+// the same type if and only if they are the same object.
+static Type **derived_slot(Type **map, int cap, TypeKind kind, Type *base, int len) {
+  uint64_t h = ((uintptr_t)base >> 3) ^ ((uint64_t)len << 32) ^ kind;
+  for (uint64_t i = h * 0x9E3779B97F4A7C15u >> 32;; i++) {
+    Type **slot = &map[i & (cap - 1)];
+    Type *ty = *slot;
+    if (!ty || (ty->kind == kind && ty->base == base && ty->array_len == len))
+      return slot;
+  }
 }
 
-Type *array_of(Type *base, int len) {
-  Type *ty = new_type(TY_ARRAY, base->size * len, base->align);
+static Type *derived_type(TypeKind kind, Type *base, int len) {
+  if (cc->derived_used * 2 >= cc->derived_cap) {
+    int cap = cc->derived_cap ? cc->derived_cap * 2 : 256;
+    Type **map = calloc(cap, sizeof(Type *));
+    for (int i = 0; i < cc->derived_cap; i++) {
+      Type *ty = cc->derived_types[i];
+      if (ty)
+        *derived_slot(map, cap, ty->kind, ty->base, ty->array_len) = ty;
+    }
+    free(cc->derived_types);
+    cc->derived_types = map;
+    cc->derived_cap = cap;
+  }
+
+  Type **slot = derived_slot(cc->derived_types, cc->derived_cap, kind, base, len);
+  if (*slot)
+    return *slot;
+
+  Type *ty;
+  if (kind == TY_PTR)
+    ty = new_type(TY_PTR, 8, 8);
+  else
+    ty = new_type(TY_ARRAY, base->size * len, base->align);
   ty->base = base;
   ty->array_len = len;
-  return ty;
+  cc->derived_used++;
+  return *slot = ty;
 }
 
-void add_type(Node *node) {
-  if (!node || node->ty)
-    return;
+Type *pointer_to(Type *base) {
+  return derived_type(TY_PTR, base, 0);
+}
 
-  add_type(node->lhs);
-  add_type(node->rhs);
-  add_type(node->cond);
-  add_type(node->then);
-  add_type(node->els);
-  add_type(node->init);
-  add_type(node->inc);
+Type *array_of(Type *base, int len) {
+  return derived_type(TY_ARRAY, base, len);
+}
 
-  for (Node *n = node->body; n; n = n->next)
-    add_type(n);
-  for (Node *n = node->args; n; n = n->next)
-    add_type(n);
+// Whether `node` designates an object whose address can be taken.
+static bool is_lvalue(Node *node) {
+  switch (node->kind) {
+    case ND_VAR:
+    case ND_DEREF:
+      return true;
+    case ND_MEMBER:
+      return is_lvalue(node->lhs);
+  }
+  return false;
+}
 
+// Assigns a type to a node whose operands have already been typed.
+static void set_type(Node *node) {
   switch (node->kind) {
     case ND_ADD:
     case ND_SUB:
@@ -63,18 +97,28 @@ void add_type(Node *node) {
     case ND_NUM:
       node->ty = int_type;
       return;
+    case ND_ASSIGN:
+      if (!is_lvalue(node->lhs) || node->lhs->ty->kind == TY_ARRAY)
+        error_tok(node->lhs->tok, "Not an lvalue");
+      node->ty = node->lhs->ty;
+      return;
     case ND_PTR_ADD:
     case ND_PTR_SUB:
-    case ND_ASSIGN:
       node->ty = node->lhs->ty;
       return;
     case ND_VAR:
       node->ty = node->var->ty;
       return;
     case ND_MEMBER:
+      if (!is_lvalue(node->lhs))
+        error_tok(node->lhs->tok, "Not an lvalue");
       node->ty = node->member->ty;
       return;
     case ND_ADDR:
+      if (!is_lvalue(node->lhs))
+        error_tok(node->lhs->tok, "Not an lvalue");
+      if (node->lhs->kind == ND_VAR)
+        node->lhs->var->addr_taken = true;
       if (node->lhs->ty->kind == TY_ARRAY)
         node->ty = pointer_to(node->lhs->ty->base);
       else
@@ -87,3 +131,104 @@ void add_type(Node *node) {
       return;
   }
 }
+
+// add_type() walks the tree with an explicit stack, so arbitrarily deep
+// input cannot overflow the C stack. Small trees never leave `buf`.
+typedef struct {
+  Node *node;
+  bool expanded; // operands have been pushed
+} TypeFrame;
+
+typedef struct {
+  TypeFrame *data;
+  int len;
+  int cap;
+  TypeFrame buf[64];
+} TypeStack;
+
+static void push_frame(TypeStack *st, Node *node, bool expanded) {
+  if (!node || node->visited)
+    return;
+
+  if (st->len == st->cap) {
+    st->cap *= 2;
+    if (st->data == st->buf) {
+      st->data = malloc(sizeof(TypeFrame) * st->cap);
+      memcpy(st->data, st->buf, sizeof(st->buf));
+    } else {
+      st->data = realloc(st->data, sizeof(TypeFrame) * st->cap);
+    }
+  }
+  st->data[st->len++] = (TypeFrame){node, expanded};
+}
+
+// Types every node under `node` in post order. Each node is visited
+// exactly once: statements get no type, but are marked as visited so
+// that nested statements typed while they were parsed are not walked
+// again.
+void add_type(Node *node) {
+  TypeStack st = {.cap = sizeof(st.buf) / sizeof(*st.buf)};
+  st.data = st.buf;
+  push_frame(&st, node, false);
+
+  while (st.len) {
+    TypeFrame f = st.data[--st.len];
+    if (f.node->visited)
+      continue;
+
+    if (f.expanded) {
+      set_type(f.node);
+      f.node->visited = true;
+      continue;
+    }
+
+    // Push the operands in reverse, so that they are typed in source
+    // order and errors are reported in the same order as before.
+    Node *n = f.node;
+    push_frame(&st, n, true);
+    int start = st.len;
+    switch (n->kind) {
+    case ND_NULL:
+    case ND_NUM:
+    case ND_VAR:
+      break;
+    case ND_IF:
+    case ND_WHILE:
+    case ND_FOR:
+      push_frame(&st, n->cond, false);
+      push_frame(&st, n->then, false);
+      push_frame(&st, n->els, false);
+      push_frame(&st, n->init, false);
+      push_frame(&st, n->inc, false);
+      break;
+    case ND_BLOCK:
+    case ND_STMT_EXPR:
+      for (Node *m = n->body; m; m = m->next)
+        push_frame(&st, m, false);
+      break;
+    case ND_FCALL:
+      for (Node *m = n->args; m; m = m->next)
+        push_frame(&st, m, false);
+      break;
+    case ND_MEMBER:
+    case ND_RETURN:
+    case ND_EXPR_STMT:
+    case ND_ADDR:
+    case ND_DEREF:
+      push_frame(&st, n->lhs, false);
+      break;
+    default:
+      push_frame(&st, n->lhs, false);
+      push_frame(&st, n->rhs, false);
+    }
+
+    for (int i = start, j = st.len - 1; i < j; i++, j--) {
+      TypeFrame tmp = st.data[i];
+      st.data[i] = st.data[j];
+      st.data[j] = tmp;
+    }
+  }
+
+  if (st.data != st.buf)
+    free(st.data);
+}